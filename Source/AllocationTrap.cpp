@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    AllocationTrap.cpp
+    Created: 17 Oct 2026 9:31:05pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#include "AllocationTrap.h"
+
+#if LAPLAND_ALLOCATION_TRAP
+
+#include <cstdlib>
+#include <new>
+
+#if JUCE_WINDOWS
+ #include <malloc.h>
+#endif
+
+namespace
+{
+    thread_local int trapDepth = 0;
+
+    void checkAllocation(const char* what) noexcept
+    {
+        if (trapDepth == 0) { return; }
+
+        //disarm while reporting, the assertion logger is allowed to allocate
+        const auto depth = trapDepth;
+        trapDepth = 0;
+
+        DBG("Lapland: " << what << " called on the audio thread");
+        jassertfalse;
+
+        trapDepth = depth;
+    }
+}
+
+ScopedAllocationTrap::ScopedAllocationTrap() noexcept { ++trapDepth; }
+ScopedAllocationTrap::~ScopedAllocationTrap() noexcept { --trapDepth; }
+
+void* operator new(std::size_t size)
+{
+    checkAllocation("operator new");
+
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size)) { return ptr; }
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr) { checkAllocation("operator delete"); }
+
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept                   { operator delete(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept        { operator delete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept      { operator delete(ptr); }
+
+//over-aligned types (SIMD members, alignas) come through these instead
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    checkAllocation("operator new");
+
+    const auto align = juce::jmax((std::size_t)alignment, sizeof(void*));
+    size = size == 0 ? 1 : size;
+
+   #if JUCE_WINDOWS
+    if (auto* ptr = _aligned_malloc(size, align)) { return ptr; }
+   #else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, align, size) == 0) { return ptr; }
+   #endif
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    if (ptr != nullptr) { checkAllocation("operator delete"); }
+
+   #if JUCE_WINDOWS
+    _aligned_free(ptr);
+   #else
+    std::free(ptr);
+   #endif
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept                { operator delete(ptr, alignment); }
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept     { operator delete(ptr, alignment); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept   { operator delete(ptr, alignment); }
+
+#endif
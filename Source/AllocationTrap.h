@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+
+    AllocationTrap.h
+    Created: 17 Oct 2026 9:31:05pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#ifndef LAPLAND_ALLOCATION_TRAP
+ #if JUCE_DEBUG
+  #define LAPLAND_ALLOCATION_TRAP 1
+ #else
+  #define LAPLAND_ALLOCATION_TRAP 0
+ #endif
+#endif
+
+/*While one of these is alive, any global new/delete on the same thread hits a jassert.
+  Wrap audio thread code in it so a stray allocation shows up in debug builds
+  instead of as a dropout under load. Compiles to nothing in release builds.*/
+class ScopedAllocationTrap
+{
+public:
+#if LAPLAND_ALLOCATION_TRAP
+    ScopedAllocationTrap() noexcept;
+    ~ScopedAllocationTrap() noexcept;
+#else
+    ScopedAllocationTrap() noexcept {}
+#endif
+
+private:
+    JUCE_DECLARE_NON_COPYABLE(ScopedAllocationTrap)
+};
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    AnalyserFifo.h
+    Created: 23 Oct 2026 2:12:37pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*Carries the mono sum of the output from processBlock to the editor's analyser.
+  Single producer, single consumer ring on juce::AbstractFifo: the audio thread writes what
+  fits and drops the rest, so it never waits for the GUI. When no analyser is open the audio
+  thread only reads one flag.*/
+class AnalyserFifo
+{
+public:
+    static constexpr int capacity = 16384;
+
+    //message thread, on while an analyser is open
+    void setEnabled(bool shouldBeEnabled) noexcept { enabled.store(shouldBeEnabled, std::memory_order_release); }
+
+    void setSampleRate(double newSampleRate) noexcept { sampleRate.store(newSampleRate, std::memory_order_relaxed); }
+    double getSampleRate() const noexcept { return sampleRate.load(std::memory_order_relaxed); }
+
+    //audio thread
+    void push(const juce::AudioBuffer<float>& buffer) noexcept
+    {
+        if (!enabled.load(std::memory_order_acquire) || buffer.getNumChannels() == 0)
+            return;
+
+        const auto* left = buffer.getReadPointer(0);
+        const auto* right = buffer.getReadPointer(juce::jmin(1, buffer.getNumChannels() - 1));
+
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(buffer.getNumSamples(), start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i) { samples[(size_t)(start1 + i)] = 0.5f * (left[i] + right[i]); }
+        for (int i = 0; i < size2; ++i) { samples[(size_t)(start2 + i)] = 0.5f * (left[size1 + i] + right[size1 + i]); }
+
+        fifo.finishedWrite(size1 + size2);
+    }
+
+    //analyser timer, returns how many samples were copied
+    int pop(float* destination, int maxSamples) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+
+        std::copy_n(samples.data() + start1, size1, destination);
+        std::copy_n(samples.data() + start2, size2, destination + size1);
+
+        fifo.finishedRead(size1 + size2);
+        return size1 + size2;
+    }
+
+private:
+    juce::AbstractFifo fifo{ capacity };
+    std::array<float, capacity> samples{};
+    std::atomic<bool> enabled{ false };
+    std::atomic<double> sampleRate{ 44100.0 };
+};
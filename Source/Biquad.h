@@ -0,0 +1,44 @@
+/*
+  ==============================================================================
+
+    Biquad.h
+    Created: 19 Oct 2026 10:41:36am
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//normalised second order section, a0 is always 1
+struct BiquadCoefficients
+{
+    float b0{ 1.0f };
+    float b1{ 0.0f };
+    float b2{ 0.0f };
+    float a1{ 0.0f };
+    float a2{ 0.0f };
+};
+
+//transposed direct form II state of one channel, same recursion as the VoiceBank lanes
+struct BiquadState
+{
+    float s1{ 0.0f };
+    float s2{ 0.0f };
+
+    void process(const BiquadCoefficients& c, float* samples, int numSamples) noexcept
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto x = samples[i];
+            const auto y = c.b0 * x + s1;
+            s1 = c.b1 * x - c.a1 * y + s2;
+            s2 = c.b2 * x - c.a2 * y;
+            samples[i] = y;
+        }
+
+        JUCE_SNAP_TO_ZERO(s1);
+        JUCE_SNAP_TO_ZERO(s2);
+    }
+};
@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    ControlRate.h
+    Created: 22 Oct 2026 11:36:48am
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*Control signals (gain, filter coefficients) are evaluated once every blockSize samples
+  on a fixed grid and ramped linearly in between, so their cost and their behaviour no longer
+  depend on the block sizes the host and the MIDI splits hand us.*/
+namespace ControlRate
+{
+    static constexpr int blockSize = 32;
+
+    //linear segment towards the next control value, one segment per control block
+    struct Ramp
+    {
+        void setTarget(float target, int numSamples) noexcept
+        {
+            step = (target - value) / (float)numSamples;
+        }
+
+        void snapTo(float target) noexcept
+        {
+            value = target;
+            step = 0.0f;
+        }
+
+        float next() noexcept
+        {
+            value += step;
+            return value;
+        }
+
+        //writes the next numSamples values, the loop has no dependency the compiler can't unroll
+        void fill(float* dest, int numSamples) noexcept
+        {
+            const auto start = value;
+
+            for (int i = 0; i < numSamples; ++i)
+                dest[i] = start + step * (float)(i + 1);
+
+            value = start + step * (float)numSamples;
+        }
+
+        bool isRamping() const noexcept { return step != 0.0f; }
+
+        float value{ 0.0f };
+        float step{ 0.0f };
+    };
+}
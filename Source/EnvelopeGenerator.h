@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    EnvelopeGenerator.h
+    Created: 23 Oct 2026 10:21:44am
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "ControlRate.h"
+
+/*Linear ADSR with the same stages and timings as juce::ADSR, computed a segment at a time.
+
+  When a stage starts, its length in samples and its end level are worked out once. Rendering
+  then fills straight lines over whole runs, up to the next stage boundary or the end of the
+  buffer, so no per sample state machine or boundary test is left in the loop. Sustain and
+  idle are constant fills.*/
+class EnvelopeGenerator
+{
+public:
+    struct Parameters
+    {
+        float attack{ 0.1f };  //seconds
+        float decay{ 0.1f };   //seconds
+        float sustain{ 1.0f }; //level
+        float release{ 0.1f }; //seconds
+    };
+
+    void setSampleRate(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        restartStage();
+    }
+
+    void setParameters(const Parameters& newParameters) noexcept
+    {
+        parameters = newParameters;
+        restartStage();
+    }
+
+    //stretches every stage time, a running stage keeps its level and covers what is left of it at the new speed
+    void setTimeScale(float newTimeScale) noexcept
+    {
+        if (newTimeScale == timeScale) { return; }
+
+        if (samplesLeft > 0)
+        {
+            segmentLength = juce::jmax(1, juce::roundToInt((float)segmentLength * newTimeScale / timeScale));
+            samplesLeft = juce::jmax(1, juce::roundToInt((float)samplesLeft * newTimeScale / timeScale));
+            level.setTarget(endLevel, samplesLeft);
+        }
+
+        timeScale = newTimeScale;
+    }
+
+    void noteOn() noexcept { beginAttack(); }
+
+    void noteOff() noexcept
+    {
+        if (stage != Stage::idle)
+            beginRelease();
+    }
+
+    void reset() noexcept
+    {
+        stage = Stage::idle;
+        samplesLeft = 0;
+        level.snapTo(0.0f);
+    }
+
+    bool isActive() const noexcept { return stage != Stage::idle; }
+
+    //writes the next numSamples levels
+    void render(float* dest, int numSamples) noexcept
+    {
+        for (int done = 0; done < numSamples;)
+        {
+            if (stage == Stage::idle || stage == Stage::sustain)
+            {
+                juce::FloatVectorOperations::fill(dest + done, level.value, numSamples - done);
+                return;
+            }
+
+            const auto run = juce::jmin(samplesLeft, numSamples - done);
+            level.fill(dest + done, run);
+            samplesLeft -= run;
+            done += run;
+
+            if (samplesLeft == 0)
+                finishStage();
+        }
+    }
+
+private:
+    enum class Stage { idle, attack, decay, sustain, release };
+
+    int secondsToSamples(float seconds) const noexcept
+    {
+        return juce::jmax(0, juce::roundToInt(seconds * timeScale * sampleRate));
+    }
+
+    //ramps from the current level to target over numSamples, or jumps there if that is none
+    void beginSegment(Stage newStage, float target, int numSamples) noexcept
+    {
+        stage = newStage;
+        endLevel = target;
+        segmentLength = samplesLeft = numSamples;
+
+        if (numSamples > 0)
+            level.setTarget(target, numSamples);
+        else
+            finishStage();
+    }
+
+    //the running stage keeps the part of it already covered and ramps to target over what is left of its new length
+    void resizeSegment(float target, int numSamples) noexcept
+    {
+        const auto fractionLeft = segmentLength > 0 ? (double)samplesLeft / (double)segmentLength : 0.0;
+
+        endLevel = target;
+        segmentLength = numSamples;
+        samplesLeft = numSamples > 0 ? juce::jmax(1, juce::roundToInt(numSamples * fractionLeft)) : 0;
+
+        if (samplesLeft > 0)
+            level.setTarget(target, samplesLeft);
+        else
+            finishStage();
+    }
+
+    //attack always rises at 1 / attack per second, a retriggered voice starts from where it is
+    void beginAttack() noexcept
+    {
+        beginSegment(Stage::attack, 1.0f, secondsToSamples((1.0f - juce::jlimit(0.0f, 1.0f, level.value)) * parameters.attack));
+    }
+
+    void beginDecay() noexcept
+    {
+        beginSegment(Stage::decay, parameters.sustain, parameters.sustain < 1.0f ? secondsToSamples(parameters.decay) : 0);
+    }
+
+    void beginRelease() noexcept
+    {
+        beginSegment(Stage::release, 0.0f, secondsToSamples(parameters.release));
+    }
+
+    void finishStage() noexcept
+    {
+        level.snapTo(endLevel);
+        segmentLength = samplesLeft = 0;
+
+        switch (stage)
+        {
+        case Stage::attack:  beginDecay(); break;
+        case Stage::decay:   stage = Stage::sustain; break;
+        case Stage::release: stage = Stage::idle; break;
+        default: break;
+        }
+    }
+
+    //new times or a new rate apply to the stage that is running from the current level, so moving a knob
+    //while a note sounds bends the running stage instead of starting it over. Attack is worked out from
+    //the level anyway, decay and release keep the fraction of their time already gone
+    void restartStage() noexcept
+    {
+        switch (stage)
+        {
+        case Stage::attack:  beginAttack(); break;
+        case Stage::decay:   resizeSegment(parameters.sustain, parameters.sustain < 1.0f ? secondsToSamples(parameters.decay) : 0); break;
+        case Stage::sustain: level.snapTo(parameters.sustain); break;
+        case Stage::release: resizeSegment(0.0f, secondsToSamples(parameters.release)); break;
+        default: break;
+        }
+    }
+
+    Parameters parameters;
+    double sampleRate{ 44100.0 };
+    float timeScale{ 1.0f };
+    Stage stage{ Stage::idle };
+    ControlRate::Ramp level; //one straight line per stage
+    float endLevel{ 0.0f };
+    int segmentLength{ 0 }; //samples in the running stage, to tell how much of it is gone
+    int samplesLeft{ 0 };
+};
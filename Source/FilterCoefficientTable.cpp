@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    FilterCoefficientTable.cpp
+    Created: 19 Oct 2026 11:05:52am
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#include "FilterCoefficientTable.h"
+
+namespace
+{
+    const double cleaningLevelRatio = std::log((double)FilterCoefficientTable::maxCleaningLevel / FilterCoefficientTable::minCleaningLevel);
+}
+
+FilterCoefficientTable::FilterCoefficientTable()
+    : table((size_t)(numNotes * numCleaningLevels))
+{
+}
+
+void FilterCoefficientTable::build(double sampleRate)
+{
+    if (sampleRate == tableSampleRate) { return; }
+
+    tableSampleRate = sampleRate;
+
+    //the top notes pass Nyquist at low sample rates, keep them just below it
+    const auto maxFrequency = sampleRate * 0.49;
+
+    for (int note = 0; note < numNotes; ++note)
+    {
+        const auto frequency = juce::jmin(juce::MidiMessage::getMidiNoteInHertz(note), maxFrequency);
+
+        for (int level = 0; level < numCleaningLevels; ++level)
+        {
+            const auto q = minCleaningLevel * std::exp(cleaningLevelRatio * level / (numCleaningLevels - 1));
+            const auto c = juce::dsp::IIR::ArrayCoefficients<double>::makeLowPass(sampleRate, frequency, q);
+            const auto a0 = c[3];
+
+            table[(size_t)(note * numCleaningLevels + level)] = { (float)(c[0] / a0), (float)(c[1] / a0), (float)(c[2] / a0),
+                                                                  (float)(c[4] / a0), (float)(c[5] / a0) };
+        }
+    }
+}
+
+BiquadCoefficients FilterCoefficientTable::getCoefficients(float midiNote, float cleaningLevel) const noexcept
+{
+    const auto notePosition = juce::jlimit(0.0f, (float)(numNotes - 1), midiNote);
+    const auto levelPosition = (float)(std::log(juce::jlimit(minCleaningLevel, maxCleaningLevel, cleaningLevel) / minCleaningLevel)
+                                       / cleaningLevelRatio * (numCleaningLevels - 1));
+
+    const auto note = juce::jmin((int)notePosition, numNotes - 2);
+    const auto level = juce::jmin((int)levelPosition, numCleaningLevels - 2);
+    const auto noteFraction = notePosition - (float)note;
+    const auto levelFraction = levelPosition - (float)level;
+
+    const auto blend = [](const BiquadCoefficients& a, const BiquadCoefficients& b, float t) -> BiquadCoefficients
+    {
+        return { a.b0 + (b.b0 - a.b0) * t, a.b1 + (b.b1 - a.b1) * t, a.b2 + (b.b2 - a.b2) * t,
+                 a.a1 + (b.a1 - a.a1) * t, a.a2 + (b.a2 - a.a2) * t };
+    };
+
+    return blend(blend(at(note, level), at(note, level + 1), levelFraction),
+                 blend(at(note + 1, level), at(note + 1, level + 1), levelFraction),
+                 noteFraction);
+}
+
+float FilterCoefficientTable::frequencyToNote(double frequency) noexcept
+{
+    return (float)(69.0 + 12.0 * std::log2(juce::jmax(frequency, 1.0) / 440.0));
+}
@@ -0,0 +1,48 @@
+/*
+  ==============================================================================
+
+    FilterCoefficientTable.h
+    Created: 19 Oct 2026 11:05:52am
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "Biquad.h"
+#include "ModulationMatrix.h"
+
+/*Low-pass coefficients for every semitone from MIDI note 0 up over a log spaced grid of CleaningLevel (the filter Q),
+  built in prepareToPlay. Voices look up plain coefficients, bilinearly interpolated between the
+  neighbouring notes and grid points, so the render path never calls tan or allocates.
+  Interpolating is safe: the stable (a1, a2) region of a biquad is a triangle, so any blend
+  of two stable filters is stable too.*/
+class FilterCoefficientTable
+{
+public:
+    //the highest MIDI note plus a full cutoffRange of modulation, note 175 or about 200 kHz. That is past Nyquist
+    //for every table up to 4x oversampling at 96 kHz, and notes past Nyquist hold the clamped top frequency, so
+    //anything bent or modulated higher looks up the same filter
+    static constexpr int topKeyNote = 127;
+    static constexpr int numNotes = topKeyNote + (int)ModulationMatrix::cutoffRange + 1;
+    static constexpr int numCleaningLevels = 32;
+    static constexpr float minCleaningLevel = 20.0f;
+    static constexpr float maxCleaningLevel = 1000.0f;
+
+    FilterCoefficientTable();
+
+    void build(double sampleRate);
+    double getSampleRate() const noexcept { return tableSampleRate; }
+
+    //midiNote may be fractional, both arguments are clamped to the table
+    BiquadCoefficients getCoefficients(float midiNote, float cleaningLevel) const noexcept;
+
+    static float frequencyToNote(double frequency) noexcept;
+
+private:
+    const BiquadCoefficients& at(int note, int level) const noexcept { return table[(size_t)(note * numCleaningLevels + level)]; }
+
+    std::vector<BiquadCoefficients> table;
+    double tableSampleRate{ 0.0 };
+};
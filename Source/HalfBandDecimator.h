@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    HalfBandDecimator.h
+    Created: 20 Oct 2026 10:14:03am
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*Halves the sample rate with a linear phase half-band FIR, in place.
+
+  Every other tap of a half-band filter is zero apart from the centre one (0.5), so it is
+  split into two polyphase branches: the odd input samples only pass through a delay, and
+  the even samples go through a short symmetric FIR. Each branch is deinterleaved into a
+  contiguous run first, so every tap pair becomes one FloatVectorOperations call over a whole
+  run of outputs instead of a scalar inner loop. The taps are a Kaiser windowed sinc.*/
+class HalfBandDecimator
+{
+public:
+    static constexpr int maxPairs = 8;
+
+    //numPairs nonzero tap pairs besides the centre, more pairs give a steeper transition band
+    void prepare(int numChannels, int numPairs, float kaiserBeta)
+    {
+        pairs = juce::jlimit(1, maxPairs, numPairs);
+
+        const auto halfLength = 2 * pairs; //distance from the centre to the first zero tap past the window
+        auto sum = 0.0;
+
+        for (int k = 0; k < pairs; ++k)
+        {
+            const auto t = (double)(2 * k + 1);
+            const auto sinc = (k % 2 == 0 ? 1.0 : -1.0) / (juce::MathConstants<double>::pi * t);
+            const auto x = t / (double)halfLength;
+            const auto window = besselI0(kaiserBeta * std::sqrt(juce::jmax(0.0, 1.0 - x * x))) / besselI0(kaiserBeta);
+
+            coefficients[(size_t)k] = (float)(sinc * window);
+            sum += sinc * window;
+        }
+
+        //the side taps have to add up to 0.5 (twice, mirrored) for unity gain at DC
+        for (int k = 0; k < pairs; ++k)
+            coefficients[(size_t)k] = (float)(coefficients[(size_t)k] * 0.25 / sum);
+
+        histories.resize((size_t)juce::jmax(1, numChannels));
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& history : histories) { history = {}; }
+    }
+
+    //output delay in samples at the lower rate
+    int getLatency() const noexcept { return pairs; }
+
+    //reads numInputSamples (even) and writes numInputSamples / 2 to the front of the same buffer
+    void process(float* samples, int channel, int numInputSamples) noexcept
+    {
+        jassert(numInputSamples % 2 == 0 && channel < (int)histories.size());
+
+        auto& history = histories[(size_t)channel];
+        const auto numOutputs = numInputSamples / 2;
+
+        for (int done = 0; done < numOutputs; done += runLength)
+        {
+            const auto run = juce::jmin(runLength, numOutputs - done);
+            const auto* input = samples + 2 * done;
+            auto* output = samples + done; //always behind the input still to be read
+
+            for (int i = 0; i < run; ++i)
+            {
+                history.even[(size_t)(historyLength + i)] = input[2 * i];
+                history.odd[(size_t)(historyLength + i)] = input[2 * i + 1];
+            }
+
+            //y[n] = 0.5 * odd[n - P] + sum over k of c[k] * (even[n - P + k + 1] + even[n - P - k]), P = pairs
+            const auto* even = history.even.data() + historyLength - pairs;
+            juce::FloatVectorOperations::copyWithMultiply(output, history.odd.data() + historyLength - pairs, 0.5f, run);
+
+            for (int k = 0; k < pairs; ++k)
+            {
+                juce::FloatVectorOperations::addWithMultiply(output, even + k + 1, coefficients[(size_t)k], run);
+                juce::FloatVectorOperations::addWithMultiply(output, even - k, coefficients[(size_t)k], run);
+            }
+
+            //keep the newest samples for the next run
+            std::copy(history.even.begin() + run, history.even.begin() + run + historyLength, history.even.begin());
+            std::copy(history.odd.begin() + run, history.odd.begin() + run + historyLength, history.odd.begin());
+        }
+    }
+
+private:
+    static constexpr int historyLength = 2 * maxPairs;
+    static constexpr int runLength = 64;
+
+    static double besselI0(double x) noexcept
+    {
+        auto sum = 1.0;
+        auto term = 1.0;
+
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    struct History
+    {
+        std::array<float, historyLength + runLength> even{};
+        std::array<float, historyLength + runLength> odd{};
+    };
+
+    std::array<float, maxPairs> coefficients{};
+    std::vector<History> histories;
+    int pairs{ 1 };
+};
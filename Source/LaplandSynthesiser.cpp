@@ -0,0 +1,429 @@
+/*
+  ==============================================================================
+
+    LaplandSynthesiser.cpp
+    Created: 20 Oct 2026 10:52:41am
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#include "LaplandSynthesiser.h"
+
+void LaplandSynthesiser::prepare(int numChannels, int maxBlockSize, int numWorkers)
+{
+    const juce::ScopedLock sl(lock);
+
+    workerPool.start(numWorkers);
+    numRenderThreads = juce::jlimit(1, getMaxRenderThreads(), numRenderThreads);
+
+    voiceBank.prepare(getNumVoices(), numChannels, getMaxRenderThreads());
+    bankVoices.resize((size_t)getMaxRenderThreads());
+    for (auto& threadVoices : bankVoices) { threadVoices.ensureStorageAllocated(getNumVoices()); }
+
+    renderList.ensureStorageAllocated(getNumVoices());
+    chunkBuffers.resize((size_t)((getNumVoices() + voicesPerChunk - 1) / voicesPerChunk));
+    for (auto& buffer : chunkBuffers) { buffer.setSize(numChannels, maxBlockSize); }
+
+    //rebuild the bookkeeping from scratch, voices may still be sounding across a prepare
+    firstActive = nullptr;
+    numActiveVoices = 0;
+    noteVoices.fill(nullptr);
+    freeVoices.reserve((size_t)getNumVoices());
+
+    for (int i = 0; i < getNumVoices(); ++i)
+    {
+        auto* voice = static_cast<SynthVoice*>(getVoice(i));
+        voice->previousActive = voice->nextActive = nullptr;
+        voice->isListed = false;
+
+        if (voice->isVoiceActive())
+        {
+            linkVoice(voice);
+            noteVoices[(size_t)voice->getCurrentlyPlayingNote()] = voice;
+        }
+    }
+
+    polyphony = juce::jlimit(1, juce::jmax(1, getNumVoices()), polyphony);
+    rebuildFreeVoices();
+}
+
+void LaplandSynthesiser::setPolyphony(int numVoices)
+{
+    numVoices = juce::jlimit(1, juce::jmax(1, getNumVoices()), numVoices);
+    if (numVoices == polyphony) { return; }
+
+    const juce::ScopedLock sl(lock);
+
+    polyphony = numVoices;
+
+    for (auto* voice = firstActive; voice != nullptr; voice = voice->nextActive)
+    {
+        if (voice->getVoiceIndex() >= polyphony && voice->isKeyDown())
+            stopVoice(voice, 1.0f, true);
+    }
+
+    rebuildFreeVoices();
+}
+
+void LaplandSynthesiser::rebuildFreeVoices()
+{
+    freeVoices.clear();
+
+    //pushed backwards so voice 0 is handed out first
+    for (int i = polyphony; --i >= 0;)
+    {
+        auto* voice = static_cast<SynthVoice*>(getVoice(i));
+        if (!voice->isListed) { freeVoices.push_back(voice); }
+    }
+}
+
+void LaplandSynthesiser::noteOn(int midiChannel, int midiNoteNumber, float velocity)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto* sound : sounds)
+    {
+        if (!sound->appliesToNote(midiNoteNumber) || !sound->appliesToChannel(midiChannel)) { continue; }
+
+        //if the note is still ringing because of the pedals, stop it first like the base class does
+        auto* ringing = noteVoices[(size_t)midiNoteNumber];
+        if (ringing != nullptr && ringing->getCurrentlyPlayingNote() == midiNoteNumber && ringing->isPlayingChannel(midiChannel))
+            stopVoice(ringing, 1.0f, true);
+
+        auto* voice = takeFreeVoice();
+        if (voice == nullptr && isNoteStealingEnabled())
+        {
+            voice = static_cast<SynthVoice*>(findVoiceToSteal(sound, midiChannel, midiNoteNumber));
+            if (voice != nullptr) { ++noteCounters.voicesStolen; }
+        }
+
+        if (voice == nullptr) { continue; }
+
+        ++noteCounters.notesStarted;
+
+        const auto& expression = channelExpression[(size_t)juce::jlimit(1, 16, midiChannel) - 1];
+        voice->setChannelExpression(expression.pitchWheel, expression.pressure, expression.controllers.data());
+        voice->setNoteOrigin(midiChannel, noteOnCount++);
+        startVoice(voice, sound, midiChannel, midiNoteNumber, velocity);
+        linkVoice(voice);
+        noteVoices[(size_t)midiNoteNumber] = voice;
+    }
+}
+
+void LaplandSynthesiser::noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff)
+{
+    const juce::ScopedLock sl(lock);
+
+    auto* voice = noteVoices[(size_t)midiNoteNumber];
+    if (voice == nullptr || voice->getCurrentlyPlayingNote() != midiNoteNumber) { return; }
+
+    //the same note held on another channel is not in the map, let the base class search for it
+    if (!voice->isPlayingChannel(midiChannel))
+    {
+        juce::Synthesiser::noteOff(midiChannel, midiNoteNumber, velocity, allowTailOff);
+        return;
+    }
+
+    voice->setKeyDown(false);
+
+    if (!(voice->isSustainPedalDown() || voice->isSostenutoPedalDown()))
+        stopVoice(voice, velocity, allowTailOff);
+}
+
+void LaplandSynthesiser::handlePitchWheel(int midiChannel, int wheelValue)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (midiChannel >= 1 && midiChannel <= 16)
+        channelExpression[(size_t)midiChannel - 1].pitchWheel = wheelValue;
+
+    for (auto* voice = firstActive; voice != nullptr; voice = voice->nextActive)
+    {
+        if (midiChannel <= 0 || voice->isPlayingChannel(midiChannel)) { voice->pitchWheelMoved(wheelValue); }
+    }
+}
+
+void LaplandSynthesiser::handleController(int midiChannel, int controllerNumber, int controllerValue)
+{
+    //the pedals are handled as in the base class
+    switch (controllerNumber)
+    {
+        case 0x40: handleSustainPedal(midiChannel, controllerValue >= 64); break;
+        case 0x42: handleSostenutoPedal(midiChannel, controllerValue >= 64); break;
+        case 0x43: handleSoftPedal(midiChannel, controllerValue >= 64); break;
+        default: break;
+    }
+
+    const juce::ScopedLock sl(lock);
+
+    if (midiChannel >= 1 && midiChannel <= 16 && controllerNumber >= 0 && controllerNumber < 128)
+        channelExpression[(size_t)midiChannel - 1].controllers[(size_t)controllerNumber] = (float)controllerValue / 127.0f;
+
+    for (auto* voice = firstActive; voice != nullptr; voice = voice->nextActive)
+    {
+        if (midiChannel <= 0 || voice->isPlayingChannel(midiChannel)) { voice->controllerMoved(controllerNumber, controllerValue); }
+    }
+}
+
+void LaplandSynthesiser::handleChannelPressure(int midiChannel, int channelPressureValue)
+{
+    const juce::ScopedLock sl(lock);
+
+    if (midiChannel >= 1 && midiChannel <= 16)
+        channelExpression[(size_t)midiChannel - 1].pressure = (float)channelPressureValue / 127.0f;
+
+    for (auto* voice = firstActive; voice != nullptr; voice = voice->nextActive)
+    {
+        if (midiChannel <= 0 || voice->isPlayingChannel(midiChannel)) { voice->channelPressureChanged(channelPressureValue); }
+    }
+}
+
+void LaplandSynthesiser::handleAftertouch(int midiChannel, int midiNoteNumber, int aftertouchValue)
+{
+    const juce::ScopedLock sl(lock);
+
+    for (auto* voice = firstActive; voice != nullptr; voice = voice->nextActive)
+    {
+        if (voice->getCurrentlyPlayingNote() == midiNoteNumber && voice->isPlayingChannel(midiChannel)) { voice->aftertouchChanged(aftertouchValue); }
+    }
+}
+
+void LaplandSynthesiser::renderBlock(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& midiData, int startSample, int numSamples)
+{
+    const juce::ScopedLock sl(lock);
+
+    const auto endSample = startSample + numSamples;
+    auto event = midiData.findNextSamplePosition(startSample);
+
+    for (auto position = startSample; position < endSample;)
+    {
+        //expression before the next control block boundary is applied now, anything else ends the sub-block where it sits
+        const auto boundary = startSample + ((position - startSample) / ControlRate::blockSize + 1) * ControlRate::blockSize;
+        auto splitAt = endSample;
+
+        for (; event != midiData.end(); ++event)
+        {
+            const auto metadata = *event;
+            if (metadata.samplePosition >= endSample) { break; }
+
+            const auto message = metadata.getMessage();
+            if (metadata.samplePosition > position && (metadata.samplePosition >= boundary || !isExpression(message)))
+            {
+                splitAt = isExpression(message) ? startSample + (metadata.samplePosition - startSample) / ControlRate::blockSize * ControlRate::blockSize
+                                                : metadata.samplePosition;
+                break;
+            }
+
+            handleMidiEvent(message);
+        }
+
+        renderVoices(outputAudio, position, splitAt - position);
+        position = splitAt;
+    }
+}
+
+bool LaplandSynthesiser::isExpression(const juce::MidiMessage& message) noexcept
+{
+    //the pedals and channel mode messages start or stop notes, so they stay sample accurate
+    if (message.isController())
+    {
+        const auto controller = message.getControllerNumber();
+        return controller != 0x40 && controller != 0x42 && controller < 120;
+    }
+
+    return message.isPitchWheel() || message.isChannelPressure() || message.isAftertouch();
+}
+
+void LaplandSynthesiser::renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples)
+{
+    renderList.clearQuick();
+
+    for (auto* voice = firstActive; voice != nullptr; voice = voice->nextActive)
+    {
+        if (voice->isVoiceActive()) { renderList.add(voice); }
+    }
+
+    const auto numChunks = (renderList.size() + voicesPerChunk - 1) / voicesPerChunk;
+
+    if (numChunks > 0)
+    {
+        const auto maxSamples = chunkBuffers.front().getNumSamples();
+
+        //hosts may hand over more than prepared, those blocks go in slices placed at the start of the chunk
+        //buffers. Shared noise is off for such blocks, so the voices never need their host position
+        if (startSample + numSamples <= maxSamples)
+        {
+            renderChunks(outputAudio, startSample, startSample, numSamples, numChunks);
+        }
+        else
+        {
+            for (int done = 0; done < numSamples; done += maxSamples)
+                renderChunks(outputAudio, startSample + done, 0, juce::jmin(maxSamples, numSamples - done), numChunks);
+        }
+    }
+
+    releaseFinishedVoices();
+}
+
+void LaplandSynthesiser::renderChunks(juce::AudioBuffer<float>& outputAudio, int outputStart, int bufferStart, int numSamples, int numChunks) noexcept
+{
+    chunkStart = bufferStart;
+    chunkLength = numSamples;
+
+    const auto numChannels = juce::jmin(outputAudio.getNumChannels(), chunkBuffers.front().getNumChannels());
+    const auto addChunk = [&](const juce::AudioBuffer<float>& buffer)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            outputAudio.addFrom(channel, outputStart, buffer, channel, bufferStart, numSamples);
+    };
+
+    if (numRenderThreads == 1)
+    {
+        //the same chunks summed in the same order as with helpers, through one buffer, so the output does not depend on the thread count
+        for (int chunk = 0; chunk < numChunks; ++chunk)
+        {
+            renderChunkInto(chunkBuffers.front(), chunk, 0);
+            addChunk(chunkBuffers.front());
+        }
+        return;
+    }
+
+    workerPool.run(*this, numChunks, numRenderThreads - 1);
+
+    //always the same order, so the sum does not depend on which thread rendered which chunk
+    for (int chunk = 0; chunk < numChunks; ++chunk)
+        addChunk(chunkBuffers[(size_t)chunk]);
+}
+
+void LaplandSynthesiser::renderChunk(int chunkIndex, int threadIndex) noexcept
+{
+    renderChunkInto(chunkBuffers[(size_t)chunkIndex], chunkIndex, threadIndex);
+}
+
+void LaplandSynthesiser::renderChunkInto(juce::AudioBuffer<float>& buffer, int chunkIndex, int threadIndex) noexcept
+{
+    buffer.clear(chunkStart, chunkLength);
+
+    const auto first = chunkIndex * voicesPerChunk;
+    renderVoiceRange(threadIndex, buffer, chunkStart, chunkLength, renderList.getRawDataPointer() + first, juce::jmin(voicesPerChunk, renderList.size() - first));
+}
+
+void LaplandSynthesiser::renderVoiceRange(int threadIndex, juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples,
+                                          SynthVoice* const* voicesToRender, int numVoicesToRender) noexcept
+{
+    auto& threadVoices = bankVoices[(size_t)threadIndex];
+    threadVoices.clearQuick();
+
+    for (int i = 0; i < numVoicesToRender; ++i)
+    {
+        auto* voice = voicesToRender[i];
+
+        if (voice->usesVoiceBank())
+        {
+            threadVoices.add(voice);
+        }
+        else
+        {
+            voice->setScratchSlot(threadIndex);
+            voice->renderNextBlock(outputAudio, startSample, numSamples);
+        }
+    }
+
+    voiceBank.render(threadIndex, outputAudio, startSample, numSamples, threadVoices.getRawDataPointer(), threadVoices.size());
+}
+
+juce::SynthesiserVoice* LaplandSynthesiser::findVoiceToSteal(juce::SynthesiserSound*, int, int) const
+{
+    SynthVoice* victim = nullptr;
+
+    for (auto* voice = firstActive; voice != nullptr; voice = voice->nextActive)
+    {
+        if (voice->getVoiceIndex() >= polyphony) { continue; }
+        if (victim == nullptr || stealsBefore(*voice, *victim)) { victim = voice; }
+    }
+
+    return victim;
+}
+
+bool LaplandSynthesiser::stealsBefore(const SynthVoice& voice, const SynthVoice& other) const noexcept
+{
+    switch (stealingPolicy)
+    {
+        case StealingPolicy::quietest:
+            if (voice.getEnvelopeLevel() != other.getEnvelopeLevel())
+                return voice.getEnvelopeLevel() < other.getEnvelopeLevel();
+            break;
+
+        case StealingPolicy::lowestPriority:
+        {
+            const auto priority = [](const SynthVoice& v) { return v.isKeyDown() ? 2 : (v.isSustainPedalDown() || v.isSostenutoPedalDown()) ? 1 : 0; };
+
+            if (priority(voice) != priority(other))
+                return priority(voice) < priority(other);
+            if (voice.getNoteVelocity() != other.getNoteVelocity())
+                return voice.getNoteVelocity() < other.getNoteVelocity();
+            break;
+        }
+
+        case StealingPolicy::oldest:
+        default:
+            break;
+    }
+
+    return voice.wasStartedBefore(other);
+}
+
+SynthVoice* LaplandSynthesiser::takeFreeVoice() noexcept
+{
+    //voices stopped without a tail since the last render are still listed
+    if (freeVoices.empty()) { releaseFinishedVoices(); }
+    if (freeVoices.empty()) { return nullptr; }
+
+    auto* voice = freeVoices.back();
+    freeVoices.pop_back();
+    return voice;
+}
+
+void LaplandSynthesiser::linkVoice(SynthVoice* voice) noexcept
+{
+    if (voice->isListed) { return; }
+
+    voice->previousActive = nullptr;
+    voice->nextActive = firstActive;
+    if (firstActive != nullptr) { firstActive->previousActive = voice; }
+
+    firstActive = voice;
+    voice->isListed = true;
+    ++numActiveVoices;
+}
+
+void LaplandSynthesiser::unlinkVoice(SynthVoice* voice) noexcept
+{
+    if (!voice->isListed) { return; }
+
+    if (voice->previousActive != nullptr) { voice->previousActive->nextActive = voice->nextActive; }
+    else { firstActive = voice->nextActive; }
+
+    if (voice->nextActive != nullptr) { voice->nextActive->previousActive = voice->previousActive; }
+
+    voice->previousActive = voice->nextActive = nullptr;
+    voice->isListed = false;
+    --numActiveVoices;
+}
+
+void LaplandSynthesiser::releaseFinishedVoices() noexcept
+{
+    for (auto* voice = firstActive; voice != nullptr;)
+    {
+        auto* next = voice->nextActive;
+
+        if (!voice->isVoiceActive())
+        {
+            unlinkVoice(voice);
+            if (voice->getVoiceIndex() < polyphony) { freeVoices.push_back(voice); }
+        }
+
+        voice = next;
+    }
+}
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+
+    LaplandSynthesiser.h
+    Created: 20 Oct 2026 10:52:41am
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SynthVoice.h"
+#include "VoiceBank.h"
+#include "RenderWorkerPool.h"
+
+/*juce::Synthesiser that hands its low-pass voices to the VoiceBank instead of rendering them one by one.
+  Sounding voices are kept in an intrusive list and notes are looked up in a 128 entry map, so note
+  on/off costs the same whatever the polyphony and idle voices are never visited.
+  Rendering is split at the exact sample of every note on/off and pedal, so timing does not depend on the host
+  buffer size. Pitch wheel, controllers and pressure are applied at the start of their ControlRate block, which
+  is as often as the voices pick them up, so an expression stream costs one sub-block per control block at most.
+  Sounding voices are rendered in fixed chunks of voicesPerChunk, each into a zeroed buffer, and the chunks are
+  summed into the output in order. More than one render thread spreads the chunks over a RenderWorkerPool, a
+  single thread walks them through one buffer, so every thread count gives bit identical output.
+  Pitch wheel, controller and pressure messages only visit the sounding voices, and the last values of
+  every channel are kept, so a new note starts from its channel's expression (with MPE, from its own).
+  Everything else (pedals, stealing) is left to the base class. Only SynthVoices may be added.*/
+class LaplandSynthesiser : public juce::Synthesiser,
+                           private RenderWorkerPool::Job
+{
+public:
+    enum class StealingPolicy
+    {
+        oldest = 0,     //the note started first
+        quietest,       //the lowest envelope level right now
+        lowestPriority  //released before pedal held before key held, then the softest, then the oldest
+    };
+
+    static constexpr int maxPolyphony = 256; //largest voice pool the processor grows to
+    static constexpr int voicesPerChunk = 8; //unit of work for the render threads, fixed so the mix order never changes
+
+    //starts or stops the helper threads, never call from the audio thread
+    void prepare(int numChannels, int maxBlockSize, int numWorkers);
+    void resetFilterStates() noexcept { voiceBank.reset(); }
+    void resetNoteOnCount() noexcept { noteOnCount = 0; }
+    void setPannedMono(bool shouldPan) noexcept { voiceBank.setPannedMono(shouldPan); }
+    bool isPannedMono() const noexcept { return voiceBank.isPannedMono(); }
+
+    //only the first numVoices voices are handed out, voices above the limit finish their tail and then stay idle
+    void setPolyphony(int numVoices);
+    int getPolyphony() const noexcept { return polyphony; }
+    void setStealingPolicy(StealingPolicy newPolicy) noexcept { stealingPolicy = newPolicy; }
+
+    //1 renders on the calling thread only, safe to change from the audio thread
+    void setNumRenderThreads(int numThreads) noexcept { numRenderThreads = juce::jlimit(1, getMaxRenderThreads(), numThreads); }
+    int getMaxRenderThreads() const noexcept { return workerPool.getNumWorkers() + 1; }
+
+    //use instead of renderNextBlock, which would split at every MIDI event
+    void renderBlock(juce::AudioBuffer<float>& outputAudio, const juce::MidiBuffer& midiData, int startSample, int numSamples);
+
+    void noteOn(int midiChannel, int midiNoteNumber, float velocity) override;
+    void noteOff(int midiChannel, int midiNoteNumber, float velocity, bool allowTailOff) override;
+    void handlePitchWheel(int midiChannel, int wheelValue) override;
+    void handleController(int midiChannel, int controllerNumber, int controllerValue) override;
+    void handleChannelPressure(int midiChannel, int channelPressureValue) override;
+    void handleAftertouch(int midiChannel, int midiNoteNumber, int aftertouchValue) override;
+
+    int getNumActiveVoices() const noexcept { return numActiveVoices; }
+
+    //counts since the last call, for the telemetry
+    struct NoteCounters
+    {
+        int notesStarted{ 0 };
+        int voicesStolen{ 0 };
+    };
+    NoteCounters takeNoteCounters() noexcept { return std::exchange(noteCounters, {}); }
+
+protected:
+    void renderVoices(juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples) override;
+    juce::SynthesiserVoice* findVoiceToSteal(juce::SynthesiserSound* soundToPlay, int midiChannel, int midiNoteNumber) const override;
+
+private:
+    static bool isExpression(const juce::MidiMessage& message) noexcept;
+    void renderChunks(juce::AudioBuffer<float>& outputAudio, int outputStart, int bufferStart, int numSamples, int numChunks) noexcept;
+    void renderChunk(int chunkIndex, int threadIndex) noexcept override;
+    void renderChunkInto(juce::AudioBuffer<float>& buffer, int chunkIndex, int threadIndex) noexcept;
+    void renderVoiceRange(int threadIndex, juce::AudioBuffer<float>& outputAudio, int startSample, int numSamples, SynthVoice* const* voicesToRender, int numVoicesToRender) noexcept;
+
+    bool stealsBefore(const SynthVoice& voice, const SynthVoice& other) const noexcept;
+    void rebuildFreeVoices();
+    SynthVoice* takeFreeVoice() noexcept;
+    void linkVoice(SynthVoice* voice) noexcept;
+    void unlinkVoice(SynthVoice* voice) noexcept;
+    void releaseFinishedVoices() noexcept;
+
+    VoiceBank voiceBank;
+    std::vector<juce::Array<SynthVoice*>> bankVoices; //one per render thread, storage reserved in prepare
+
+    juce::Array<SynthVoice*> renderList; //sounding voices in list order, split into chunks
+    std::vector<juce::AudioBuffer<float>> chunkBuffers; //one per chunk, sized to the prepared block, a single thread only uses the first
+    int chunkStart{ 0 };
+    int chunkLength{ 0 };
+    int numRenderThreads{ 1 };
+
+    int polyphony{ maxPolyphony };
+    StealingPolicy stealingPolicy{ StealingPolicy::oldest };
+
+    SynthVoice* firstActive{ nullptr };
+    int numActiveVoices{ 0 };
+    NoteCounters noteCounters;
+    juce::uint32 noteOnCount{ 0 }; //notes started since resetNoteOnCount, part of each note's noise seed
+    std::vector<SynthVoice*> freeVoices; //used as a stack, reserved in prepare so push/pop never allocate
+    std::array<SynthVoice*, 128> noteVoices{}; //last voice started on each note, checked before use
+
+    //last expression values per MIDI channel, handed to each voice that starts on the channel
+    struct ChannelExpression
+    {
+        int pitchWheel{ 8192 };
+        float pressure{ 0.0f };
+        std::array<float, 128> controllers{}; //0..1
+    };
+    std::array<ChannelExpression, 16> channelExpression;
+
+    RenderWorkerPool workerPool; //last, so the threads are stopped before anything they touch goes away
+};
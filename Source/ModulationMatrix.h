@@ -0,0 +1,108 @@
+/*
+  ==============================================================================
+
+    ModulationMatrix.h
+    Created: 23 Oct 2026 5:40:26pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*Routing from per note expression to the voice. A few slots each connect one source to one
+  destination with a bipolar amount. Sources are the MIDI values of the note's channel,
+  normalised: pitch bend in -1..1, everything else in 0..1. With MPE every note has a channel of
+  its own, so channel pressure, slide (CC 74) and pitch bend are per note without special handling.
+  A full amount on a full source moves a destination by its range below.
+  The routing is a small value type, the processor hands a copy to every voice.*/
+struct ModulationMatrix
+{
+    enum Source
+    {
+        off = 0,
+        pitchBend,
+        pressure,       //channel pressure, or polyphonic aftertouch on the note
+        slide,          //CC 74, the MPE timbre dimension
+        modWheel,       //CC 1
+        controller,     //the assignable CC
+        numSources
+    };
+
+    enum Destination
+    {
+        cutoff = 0,
+        resonance,
+        gain,
+        envelopeTime,   //scales attack, decay and release
+        numDestinations
+    };
+
+    static constexpr int numSlots = 3;
+
+    static constexpr float cutoffRange = 48.0f;         //semitones
+    static constexpr float resonanceRange = 2.0f;       //octaves of Q
+    static constexpr float gainRange = 24.0f;           //dB
+    static constexpr float envelopeTimeRange = 2.0f;    //octaves of time, positive is slower
+
+    static constexpr int slideController = 74;
+    static constexpr int modWheelController = 1;
+
+    struct Slot
+    {
+        int source{ off };
+        int destination{ cutoff };
+        float amount{ 0.0f };
+
+        bool operator!= (const Slot& other) const noexcept
+        {
+            return source != other.source || destination != other.destination || amount != other.amount;
+        }
+    };
+
+    using Sources = std::array<float, numSources>;
+    using Destinations = std::array<float, numDestinations>;
+
+    //sum of amount * source per destination, in units of the ranges above
+    Destinations evaluate(const Sources& sources) const noexcept
+    {
+        Destinations result{};
+
+        for (const auto& slot : slots)
+        {
+            if (slot.source > off && slot.source < numSources && slot.destination >= 0 && slot.destination < numDestinations)
+                result[(size_t)slot.destination] += slot.amount * sources[(size_t)slot.source];
+        }
+
+        return result;
+    }
+
+    //the most the routing can stretch the envelope times, for the tail length.
+    //Pitch bend swings both ways, every other source only goes up from zero
+    float getMaxEnvelopeTimeScale() const noexcept
+    {
+        auto octaves = 0.0f;
+
+        for (const auto& slot : slots)
+        {
+            if (slot.destination != envelopeTime || slot.source <= off || slot.source >= numSources) { continue; }
+            octaves += slot.source == pitchBend ? std::abs(slot.amount) : juce::jmax(0.0f, slot.amount);
+        }
+
+        return std::exp2(octaves * envelopeTimeRange);
+    }
+
+    //which source a controller feeds, off if none
+    int sourceForController(int controllerNumber) const noexcept
+    {
+        if (controllerNumber == assignableController) { return ModulationMatrix::controller; }
+        if (controllerNumber == slideController) { return slide; }
+        if (controllerNumber == modWheelController) { return modWheel; }
+        return off;
+    }
+
+    std::array<Slot, numSlots> slots;
+    int assignableController{ 2 };
+    float bendRange{ 2.0f }; //semitones at full pitch bend, always applied to the note's pitch
+};
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+    NoiseGenerator.h
+    Created: 18 Oct 2026 11:02:17am
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <immintrin.h>
+#elif JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
+/*White noise for the voices, filled a whole block at a time.
+  Sixteen independent xorshift32 lanes are stepped together (two AVX2 registers, four SSE/NEON
+  registers or a plain loop), and each 32 bit state becomes a float by putting its top
+  23 bits into the mantissa of a number in [2, 4) and subtracting 3. The output is uniform
+  in [-1, 1) just like random.nextFloat() * 2 - 1, and every code path produces the same
+  sequence for a given seed.*/
+class NoiseGenerator
+{
+public:
+    static constexpr int numLanes = 16;
+
+    NoiseGenerator() { setSeed(juce::Random::getSystemRandom().nextInt64()); }
+
+    void setSeed(juce::int64 seed) noexcept
+    {
+        //splitmix64 to spread one seed over all lanes, a lane must never be zero
+        auto x = (juce::uint64)seed;
+        for (auto& lane : state)
+        {
+            x += 0x9e3779b97f4a7c15ull;
+            auto z = x;
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            z ^= z >> 31;
+            lane = (juce::uint32)z != 0 ? (juce::uint32)z : 0x6d2b79f5u;
+        }
+    }
+
+    //writes numSamples values in [-level, level)
+    void fill(float* dest, int numSamples, float level = 1.0f) noexcept
+    {
+        const auto numBatches = numSamples / numLanes;
+        generate(dest, numBatches, level);
+
+        if (const auto remaining = numSamples - numBatches * numLanes; remaining > 0)
+        {
+            alignas(32) float tail[numLanes];
+            generate(tail, 1, level);
+            std::copy(tail, tail + remaining, dest + numBatches * numLanes);
+        }
+    }
+
+private:
+    //the lane states stay in registers for the whole run, numBatches * numLanes floats are written
+    void generate(float* dest, int numBatches, float level) noexcept
+    {
+       #if JUCE_USE_SSE_INTRINSICS && defined (__AVX2__)
+        constexpr int width = 8;
+        __m256i x[numLanes / width];
+        for (int r = 0; r < numLanes / width; ++r) { x[r] = _mm256_load_si256((const __m256i*)(state + r * width)); }
+
+        const auto exponent = _mm256_set1_epi32(0x40000000);
+        const auto offset = _mm256_set1_ps(3.0f);
+        const auto gain = _mm256_set1_ps(level);
+
+        for (int batch = 0; batch < numBatches; ++batch, dest += numLanes)
+        {
+            for (int r = 0; r < numLanes / width; ++r)
+            {
+                x[r] = _mm256_xor_si256(x[r], _mm256_slli_epi32(x[r], 13));
+                x[r] = _mm256_xor_si256(x[r], _mm256_srli_epi32(x[r], 17));
+                x[r] = _mm256_xor_si256(x[r], _mm256_slli_epi32(x[r], 5));
+
+                const auto noise = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(x[r], 9), exponent)), offset);
+                _mm256_storeu_ps(dest + r * width, _mm256_mul_ps(noise, gain));
+            }
+        }
+
+        for (int r = 0; r < numLanes / width; ++r) { _mm256_store_si256((__m256i*)(state + r * width), x[r]); }
+       #elif JUCE_USE_SSE_INTRINSICS
+        constexpr int width = 4;
+        __m128i x[numLanes / width];
+        for (int r = 0; r < numLanes / width; ++r) { x[r] = _mm_load_si128((const __m128i*)(state + r * width)); }
+
+        const auto exponent = _mm_set1_epi32(0x40000000);
+        const auto offset = _mm_set1_ps(3.0f);
+        const auto gain = _mm_set1_ps(level);
+
+        for (int batch = 0; batch < numBatches; ++batch, dest += numLanes)
+        {
+            for (int r = 0; r < numLanes / width; ++r)
+            {
+                x[r] = _mm_xor_si128(x[r], _mm_slli_epi32(x[r], 13));
+                x[r] = _mm_xor_si128(x[r], _mm_srli_epi32(x[r], 17));
+                x[r] = _mm_xor_si128(x[r], _mm_slli_epi32(x[r], 5));
+
+                const auto noise = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(x[r], 9), exponent)), offset);
+                _mm_storeu_ps(dest + r * width, _mm_mul_ps(noise, gain));
+            }
+        }
+
+        for (int r = 0; r < numLanes / width; ++r) { _mm_store_si128((__m128i*)(state + r * width), x[r]); }
+       #elif JUCE_USE_ARM_NEON
+        constexpr int width = 4;
+        uint32x4_t x[numLanes / width];
+        for (int r = 0; r < numLanes / width; ++r) { x[r] = vld1q_u32(state + r * width); }
+
+        const auto exponent = vdupq_n_u32(0x40000000u);
+        const auto offset = vdupq_n_f32(3.0f);
+
+        for (int batch = 0; batch < numBatches; ++batch, dest += numLanes)
+        {
+            for (int r = 0; r < numLanes / width; ++r)
+            {
+                x[r] = veorq_u32(x[r], vshlq_n_u32(x[r], 13));
+                x[r] = veorq_u32(x[r], vshrq_n_u32(x[r], 17));
+                x[r] = veorq_u32(x[r], vshlq_n_u32(x[r], 5));
+
+                const auto noise = vsubq_f32(vreinterpretq_f32_u32(vorrq_u32(vshrq_n_u32(x[r], 9), exponent)), offset);
+                vst1q_f32(dest + r * width, vmulq_n_f32(noise, level));
+            }
+        }
+
+        for (int r = 0; r < numLanes / width; ++r) { vst1q_u32(state + r * width, x[r]); }
+       #else
+        for (int batch = 0; batch < numBatches; ++batch, dest += numLanes)
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                auto x = state[lane];
+                x ^= x << 13;
+                x ^= x >> 17;
+                x ^= x << 5;
+                state[lane] = x;
+
+                const juce::uint32 bits = (x >> 9) | 0x40000000u;
+                float noise;
+                std::memcpy(&noise, &bits, sizeof(float));
+                dest[lane] = (noise - 3.0f) * level;
+            }
+        }
+       #endif
+    }
+
+    alignas(32) juce::uint32 state[numLanes];
+};
@@ -0,0 +1,270 @@
+/*
+  ==============================================================================
+
+    ParameterSnapshot.h
+    Created: 18 Oct 2026 5:20:11pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "ModulationMatrix.h"
+
+/*Plain copy of every parameter, taken once at the start of processBlock.
+  Comparing two of them tells the processor which voice settings actually changed.*/
+struct ParameterSnapshot
+{
+    float keyFreq{ 0.0f };
+    float cleaningLevel{ 0.0f };
+
+    float attack{ 0.0f };
+    float decay{ 0.0f };
+    float sustain{ 0.0f };
+    float release{ 0.0f };
+
+    float volume{ 0.0f };
+
+    int noiseMode{ 0 };
+    int filterMode{ 0 };
+
+    int polyphony{ 1 };
+    int stealingPolicy{ 0 };
+    int renderThreads{ 1 };
+
+    int oversampling{ 0 }; //0 off, 1 for 2x, 2 for 4x
+
+    int partials{ 16 };
+    float partialTilt{ 0.0f };
+    float partialDamping{ 0.0f };
+
+    float silenceFloor{ -120.0f };
+
+    int stereoMode{ 0 }; //0 independent channels, 1 mono render then pan
+    float width{ 0.0f };
+
+    float bendRange{ 2.0f };
+    int modController{ 2 };
+    std::array<int, ModulationMatrix::numSlots> modSource{};
+    std::array<int, ModulationMatrix::numSlots> modDestination{};
+    std::array<float, ModulationMatrix::numSlots> modAmount{};
+
+    static constexpr const char* modSourceIDs[ModulationMatrix::numSlots] = { "ModSource1", "ModSource2", "ModSource3" };
+    static constexpr const char* modDestinationIDs[ModulationMatrix::numSlots] = { "ModDestination1", "ModDestination2", "ModDestination3" };
+    static constexpr const char* modAmountIDs[ModulationMatrix::numSlots] = { "ModAmount1", "ModAmount2", "ModAmount3" };
+
+    ModulationMatrix getModulationMatrix() const noexcept
+    {
+        ModulationMatrix matrix;
+        matrix.bendRange = bendRange;
+        matrix.assignableController = modController;
+
+        for (int slot = 0; slot < ModulationMatrix::numSlots; ++slot)
+            matrix.slots[(size_t)slot] = { modSource[(size_t)slot], modDestination[(size_t)slot], modAmount[(size_t)slot] };
+
+        return matrix;
+    }
+
+    bool modulationDiffersFrom(const ParameterSnapshot& other) const noexcept
+    {
+        return bendRange != other.bendRange || modController != other.modController || modSource != other.modSource
+            || modDestination != other.modDestination || modAmount != other.modAmount;
+    }
+
+    bool adsrDiffersFrom(const ParameterSnapshot& other) const noexcept
+    {
+        return attack != other.attack || decay != other.decay || sustain != other.sustain || release != other.release;
+    }
+
+    bool partialsDifferFrom(const ParameterSnapshot& other) const noexcept
+    {
+        return partials != other.partials || partialTilt != other.partialTilt || partialDamping != other.partialDamping;
+    }
+
+    //calls fn(parameterID, float&) for every field, choice and int parameters go through a float like in the value tree
+    template <typename Function>
+    void forEachValue(Function&& fn)
+    {
+        fn("KeyFreq", keyFreq);
+        fn("CleaningLevel", cleaningLevel);
+
+        fn("Attack", attack);
+        fn("Decay", decay);
+        fn("Sustain", sustain);
+        fn("Release", release);
+
+        fn("Volume", volume);
+
+        forIntValue(fn, "NoiseMode", noiseMode);
+        forIntValue(fn, "FilterMode", filterMode);
+
+        forIntValue(fn, "Polyphony", polyphony);
+        forIntValue(fn, "VoiceStealing", stealingPolicy);
+        forIntValue(fn, "RenderThreads", renderThreads);
+
+        forIntValue(fn, "Oversampling", oversampling);
+
+        forIntValue(fn, "Partials", partials);
+        fn("PartialTilt", partialTilt);
+        fn("PartialDamping", partialDamping);
+
+        fn("SilenceFloor", silenceFloor);
+
+        forIntValue(fn, "StereoMode", stereoMode);
+        fn("Width", width);
+
+        fn("BendRange", bendRange);
+        forIntValue(fn, "ModController", modController);
+
+        for (int slot = 0; slot < ModulationMatrix::numSlots; ++slot)
+        {
+            forIntValue(fn, modSourceIDs[slot], modSource[(size_t)slot]);
+            forIntValue(fn, modDestinationIDs[slot], modDestination[(size_t)slot]);
+            fn(modAmountIDs[slot], modAmount[(size_t)slot]);
+        }
+    }
+
+    static constexpr int numValues = 21 + 3 * ModulationMatrix::numSlots;
+
+private:
+    template <typename Function>
+    static void forIntValue(Function& fn, const char* parameterID, int& field)
+    {
+        auto value = (float)field;
+        fn(parameterID, value);
+        field = juce::roundToInt(value);
+    }
+};
+
+/*The raw parameter atomics, looked up by ID once after the parameters are created,
+  so the audio thread never searches the value tree by string.*/
+struct ParameterAtomics
+{
+    void attachTo(juce::AudioProcessorValueTreeState& apvts)
+    {
+        keyFreq = apvts.getRawParameterValue("KeyFreq");
+        cleaningLevel = apvts.getRawParameterValue("CleaningLevel");
+
+        attack = apvts.getRawParameterValue("Attack");
+        decay = apvts.getRawParameterValue("Decay");
+        sustain = apvts.getRawParameterValue("Sustain");
+        release = apvts.getRawParameterValue("Release");
+
+        volume = apvts.getRawParameterValue("Volume");
+
+        noiseMode = apvts.getRawParameterValue("NoiseMode");
+        filterMode = apvts.getRawParameterValue("FilterMode");
+
+        polyphony = apvts.getRawParameterValue("Polyphony");
+        stealingPolicy = apvts.getRawParameterValue("VoiceStealing");
+        renderThreads = apvts.getRawParameterValue("RenderThreads");
+
+        oversampling = apvts.getRawParameterValue("Oversampling");
+
+        partials = apvts.getRawParameterValue("Partials");
+        partialTilt = apvts.getRawParameterValue("PartialTilt");
+        partialDamping = apvts.getRawParameterValue("PartialDamping");
+
+        silenceFloor = apvts.getRawParameterValue("SilenceFloor");
+
+        stereoMode = apvts.getRawParameterValue("StereoMode");
+        width = apvts.getRawParameterValue("Width");
+
+        bendRange = apvts.getRawParameterValue("BendRange");
+        modController = apvts.getRawParameterValue("ModController");
+
+        for (int slot = 0; slot < ModulationMatrix::numSlots; ++slot)
+        {
+            modSource[(size_t)slot] = apvts.getRawParameterValue(ParameterSnapshot::modSourceIDs[slot]);
+            modDestination[(size_t)slot] = apvts.getRawParameterValue(ParameterSnapshot::modDestinationIDs[slot]);
+            modAmount[(size_t)slot] = apvts.getRawParameterValue(ParameterSnapshot::modAmountIDs[slot]);
+            jassert(modSource[(size_t)slot] != nullptr && modDestination[(size_t)slot] != nullptr && modAmount[(size_t)slot] != nullptr);
+        }
+
+        jassert(keyFreq != nullptr && cleaningLevel != nullptr && attack != nullptr && decay != nullptr
+                && sustain != nullptr && release != nullptr && volume != nullptr && noiseMode != nullptr && filterMode != nullptr
+                && polyphony != nullptr && stealingPolicy != nullptr && renderThreads != nullptr && oversampling != nullptr
+                && partials != nullptr && partialTilt != nullptr && partialDamping != nullptr && silenceFloor != nullptr
+                && stereoMode != nullptr && width != nullptr && bendRange != nullptr && modController != nullptr);
+    }
+
+    ParameterSnapshot load() const noexcept
+    {
+        ParameterSnapshot snapshot;
+
+        snapshot.keyFreq = keyFreq->load(std::memory_order_relaxed);
+        snapshot.cleaningLevel = cleaningLevel->load(std::memory_order_relaxed);
+
+        snapshot.attack = attack->load(std::memory_order_relaxed);
+        snapshot.decay = decay->load(std::memory_order_relaxed);
+        snapshot.sustain = sustain->load(std::memory_order_relaxed);
+        snapshot.release = release->load(std::memory_order_relaxed);
+
+        snapshot.volume = volume->load(std::memory_order_relaxed);
+
+        snapshot.noiseMode = (int)noiseMode->load(std::memory_order_relaxed);
+        snapshot.filterMode = (int)filterMode->load(std::memory_order_relaxed);
+
+        snapshot.polyphony = (int)polyphony->load(std::memory_order_relaxed);
+        snapshot.stealingPolicy = (int)stealingPolicy->load(std::memory_order_relaxed);
+        snapshot.renderThreads = (int)renderThreads->load(std::memory_order_relaxed);
+
+        snapshot.oversampling = (int)oversampling->load(std::memory_order_relaxed);
+
+        snapshot.partials = (int)partials->load(std::memory_order_relaxed);
+        snapshot.partialTilt = partialTilt->load(std::memory_order_relaxed);
+        snapshot.partialDamping = partialDamping->load(std::memory_order_relaxed);
+
+        snapshot.silenceFloor = silenceFloor->load(std::memory_order_relaxed);
+
+        snapshot.stereoMode = (int)stereoMode->load(std::memory_order_relaxed);
+        snapshot.width = width->load(std::memory_order_relaxed);
+
+        snapshot.bendRange = bendRange->load(std::memory_order_relaxed);
+        snapshot.modController = (int)modController->load(std::memory_order_relaxed);
+
+        for (size_t slot = 0; slot < (size_t)ModulationMatrix::numSlots; ++slot)
+        {
+            snapshot.modSource[slot] = (int)modSource[slot]->load(std::memory_order_relaxed);
+            snapshot.modDestination[slot] = (int)modDestination[slot]->load(std::memory_order_relaxed);
+            snapshot.modAmount[slot] = modAmount[slot]->load(std::memory_order_relaxed);
+        }
+
+        return snapshot;
+    }
+
+    std::atomic<float>* keyFreq{ nullptr };
+    std::atomic<float>* cleaningLevel{ nullptr };
+
+    std::atomic<float>* attack{ nullptr };
+    std::atomic<float>* decay{ nullptr };
+    std::atomic<float>* sustain{ nullptr };
+    std::atomic<float>* release{ nullptr };
+
+    std::atomic<float>* volume{ nullptr };
+
+    std::atomic<float>* noiseMode{ nullptr };
+    std::atomic<float>* filterMode{ nullptr };
+
+    std::atomic<float>* polyphony{ nullptr };
+    std::atomic<float>* stealingPolicy{ nullptr };
+    std::atomic<float>* renderThreads{ nullptr };
+
+    std::atomic<float>* oversampling{ nullptr };
+
+    std::atomic<float>* partials{ nullptr };
+    std::atomic<float>* partialTilt{ nullptr };
+    std::atomic<float>* partialDamping{ nullptr };
+
+    std::atomic<float>* silenceFloor{ nullptr };
+
+    std::atomic<float>* stereoMode{ nullptr };
+    std::atomic<float>* width{ nullptr };
+
+    std::atomic<float>* bendRange{ nullptr };
+    std::atomic<float>* modController{ nullptr };
+    std::array<std::atomic<float>*, ModulationMatrix::numSlots> modSource{};
+    std::array<std::atomic<float>*, ModulationMatrix::numSlots> modDestination{};
+    std::array<std::atomic<float>*, ModulationMatrix::numSlots> modAmount{};
+};
@@ -0,0 +1,162 @@
+/*
+  ==============================================================================
+
+    PerformanceTelemetry.cpp
+    Created: 21 Oct 2026 5:22:48pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#include "PerformanceTelemetry.h"
+
+class PerformanceTelemetry::DumpThread : public juce::Thread
+{
+public:
+    DumpThread(Ring& ringToDrain, std::unique_ptr<juce::FileOutputStream> outputStream)
+        : juce::Thread("Lapland stats dump"), ring(ringToDrain), stream(std::move(outputStream))
+    {
+        *stream << "render_us,deadline_us,active_voices,notes_started,voices_stolen,coefficient_updates\n";
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit())
+        {
+            wait(100);
+            drain();
+        }
+
+        drain();
+    }
+
+private:
+    void drain()
+    {
+        BlockTelemetry reports[64];
+
+        for (int count; (count = ring.pop(reports, juce::numElementsInArray(reports))) > 0;)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                const auto& r = reports[i];
+                *stream << juce::String(r.renderMicroseconds, 1) << "," << juce::String(r.deadlineMicroseconds, 1) << ","
+                        << r.activeVoices << "," << r.notesStarted << "," << r.voicesStolen << "," << r.coefficientUpdates << "\n";
+            }
+        }
+
+        stream->flush();
+    }
+
+    Ring& ring;
+    std::unique_ptr<juce::FileOutputStream> stream;
+};
+
+bool PerformanceTelemetry::Ring::push(const BlockTelemetry& report) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(1, start1, size1, start2, size2);
+    if (size1 + size2 < 1) { return false; }
+
+    reports[(size_t)(size1 > 0 ? start1 : start2)] = report;
+    fifo.finishedWrite(1);
+    return true;
+}
+
+int PerformanceTelemetry::Ring::pop(BlockTelemetry* destination, int maxReports) noexcept
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead(maxReports, start1, size1, start2, size2);
+
+    std::copy_n(reports.begin() + start1, size1, destination);
+    std::copy_n(reports.begin() + start2, size2, destination + size1);
+
+    fifo.finishedRead(size1 + size2);
+    return size1 + size2;
+}
+
+PerformanceTelemetry::PerformanceTelemetry() = default;
+
+PerformanceTelemetry::~PerformanceTelemetry()
+{
+    stopDump();
+}
+
+void PerformanceTelemetry::publish(const BlockTelemetry& report) noexcept
+{
+    blocks.fetch_add(1, std::memory_order_relaxed);
+    voicesStolen.fetch_add((juce::uint64)report.voicesStolen, std::memory_order_relaxed);
+    coefficientUpdates.fetch_add((juce::uint64)report.coefficientUpdates, std::memory_order_relaxed);
+
+    if (report.renderMicroseconds > report.deadlineMicroseconds)
+        deadlineMisses.fetch_add(1, std::memory_order_relaxed);
+    else if (report.renderMicroseconds > report.deadlineMicroseconds * nearMissRatio)
+        nearMisses.fetch_add(1, std::memory_order_relaxed);
+
+    if (editorActive.load(std::memory_order_acquire) && !editorRing.push(report))
+        droppedReports.fetch_add(1, std::memory_order_relaxed);
+
+    if (dumpActive.load(std::memory_order_acquire) && !dumpRing.push(report))
+        droppedReports.fetch_add(1, std::memory_order_relaxed);
+}
+
+void PerformanceTelemetry::setEditorActive(bool shouldBeActive) noexcept
+{
+    if (shouldBeActive)
+    {
+        //whatever the last editor left unread is stale, the message thread is the ring's reader so it may drain it
+        BlockTelemetry discard[64];
+        while (editorRing.pop(discard, juce::numElementsInArray(discard)) > 0) {}
+    }
+
+    editorActive.store(shouldBeActive, std::memory_order_release);
+}
+
+PerformanceTelemetry::Totals PerformanceTelemetry::getTotals() const noexcept
+{
+    Totals totals;
+    totals.blocks = blocks.load(std::memory_order_relaxed);
+    totals.deadlineMisses = deadlineMisses.load(std::memory_order_relaxed);
+    totals.nearMisses = nearMisses.load(std::memory_order_relaxed);
+    totals.voicesStolen = voicesStolen.load(std::memory_order_relaxed);
+    totals.coefficientUpdates = coefficientUpdates.load(std::memory_order_relaxed);
+    totals.droppedReports = droppedReports.load(std::memory_order_relaxed);
+    return totals;
+}
+
+void PerformanceTelemetry::startDump(const juce::File& file)
+{
+    stopDump();
+
+    file.deleteFile();
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+    if (!stream->openedOk()) { return; }
+
+    //reports left over from an earlier dump are stale
+    BlockTelemetry discard[64];
+    while (dumpRing.pop(discard, juce::numElementsInArray(discard)) > 0) {}
+
+    dumpThread = std::make_unique<DumpThread>(dumpRing, std::move(stream));
+    dumpThread->startThread();
+    dumpActive.store(true, std::memory_order_release);
+}
+
+juce::File PerformanceTelemetry::getInstanceDumpFile(const juce::File& requested)
+{
+    static const auto processTag = juce::String::toHexString(juce::Random::getSystemRandom().nextInt());
+    static std::atomic<int> numInstances{ 0 };
+
+    return requested.getSiblingFile(requested.getFileNameWithoutExtension() + "-" + processTag + "-"
+                                    + juce::String(++numInstances) + requested.getFileExtension());
+}
+
+void PerformanceTelemetry::stopDump()
+{
+    dumpActive.store(false, std::memory_order_release);
+
+    if (dumpThread != nullptr)
+    {
+        dumpThread->stopThread(1000);
+        dumpThread.reset();
+    }
+}
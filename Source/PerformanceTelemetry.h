@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    PerformanceTelemetry.h
+    Created: 21 Oct 2026 5:22:48pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//what processBlock reports about one block
+struct BlockTelemetry
+{
+    float renderMicroseconds{ 0.0f };
+    float deadlineMicroseconds{ 0.0f }; //length of the block in real time
+    int activeVoices{ 0 };
+    int notesStarted{ 0 };
+    int voicesStolen{ 0 };
+    int coefficientUpdates{ 0 }; //filter coefficient refreshes, from note starts and parameter changes
+};
+
+/*Per block performance counters, published by the audio thread without locks or allocation.
+  Every report goes into two single producer, single consumer rings: one drained by the editor,
+  one drained by an optional background thread that writes a CSV line per block. Each ring is only
+  fed while its reader exists, and a full ring drops the report and counts the drop. Running totals
+  are plain relaxed atomics.*/
+class PerformanceTelemetry
+{
+public:
+    static constexpr int ringSize = 1024;
+    static constexpr float nearMissRatio = 0.8f; //blocks using more of their deadline than this are near misses
+
+    struct Totals
+    {
+        juce::uint64 blocks{ 0 };
+        juce::uint64 deadlineMisses{ 0 };
+        juce::uint64 nearMisses{ 0 };
+        juce::uint64 voicesStolen{ 0 };
+        juce::uint64 coefficientUpdates{ 0 };
+        juce::uint64 droppedReports{ 0 };
+    };
+
+    PerformanceTelemetry();
+    ~PerformanceTelemetry();
+
+    //audio thread only
+    void publish(const BlockTelemetry& report) noexcept;
+
+    //message thread, on while an editor is open
+    void setEditorActive(bool shouldBeActive) noexcept;
+
+    //the editor is the only reader of its ring, returns how many reports were copied
+    int readForEditor(BlockTelemetry* destination, int maxReports) noexcept { return editorRing.pop(destination, maxReports); }
+    Totals getTotals() const noexcept;
+
+    //message thread, the file is replaced
+    void startDump(const juce::File& file);
+    void stopDump();
+
+    //file beside the requested one, with a tag for this process and a number for this instance, so
+    //instances in one session or in several hosts never write over each other's dumps
+    static juce::File getInstanceDumpFile(const juce::File& requested);
+
+private:
+    class Ring
+    {
+    public:
+        bool push(const BlockTelemetry& report) noexcept;
+        int pop(BlockTelemetry* destination, int maxReports) noexcept;
+
+    private:
+        juce::AbstractFifo fifo{ ringSize };
+        std::array<BlockTelemetry, ringSize> reports;
+    };
+
+    class DumpThread;
+
+    Ring editorRing;
+    Ring dumpRing;
+    std::atomic<bool> editorActive{ false };
+    std::atomic<bool> dumpActive{ false };
+    std::unique_ptr<DumpThread> dumpThread;
+
+    std::atomic<juce::uint64> blocks{ 0 };
+    std::atomic<juce::uint64> deadlineMisses{ 0 };
+    std::atomic<juce::uint64> nearMisses{ 0 };
+    std::atomic<juce::uint64> voicesStolen{ 0 };
+    std::atomic<juce::uint64> coefficientUpdates{ 0 };
+    std::atomic<juce::uint64> droppedReports{ 0 };
+};
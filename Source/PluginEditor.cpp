@@ -11,7 +11,7 @@
 
 //==============================================================================
 LaplandAudioProcessorEditor::LaplandAudioProcessorEditor(LaplandAudioProcessor& p)
-    : AudioProcessorEditor(&p), audioProcessor(p)
+    : AudioProcessorEditor(&p), analyser(p.getAnalyserFifo()), audioProcessor(p)
 {
 
     auto image = juce::ImageCache::getFromMemory(BinaryData::logo_png, BinaryData::logo_pngSize);
@@ -27,7 +27,7 @@ LaplandAudioProcessorEditor::LaplandAudioProcessorEditor(LaplandAudioProcessor&
 
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize(400, 400);
+    setSize(400, 500);
 
     setSlider(keyFreqSlider, 20.0f, 20000.0f, 1000.0f);
     setSlider(cleaningNoiseSlider, 20.0f, 1000.0f, 1000.0f);
@@ -57,30 +57,38 @@ LaplandAudioProcessorEditor::LaplandAudioProcessorEditor(LaplandAudioProcessor&
     setSlider(volumeSlider, 0.0f, 0.09f, 0.06f);
     setLabel(volumeLabel);
     volumeAttch = std::make_unique<Attachment>(audioProcessor.apvts, "Volume", volumeSlider);
+
+    addAndMakeVisible(analyser);
+
+    setLabel(telemetryLabel);
+    telemetryLabel.setFont(12.0f);
+    audioProcessor.getTelemetry().setEditorActive(true);
+    startTimerHz(10);
 }
 
 LaplandAudioProcessorEditor::~LaplandAudioProcessorEditor()
 {
+    stopTimer();
+    audioProcessor.getTelemetry().setEditorActive(false);
 }
 
 //==============================================================================
 void LaplandAudioProcessorEditor::paint(juce::Graphics& g)
 {
+    g.drawImageAt(background, 0, 0);
+}
 
+void LaplandAudioProcessorEditor::resized()
+{
     juce::Colour coldgreen(0, 115, 105);
     juce::Colour darkpink(135, 0, 95);
 
+    background = juce::Image(juce::Image::RGB, juce::jmax(1, getWidth()), juce::jmax(1, getHeight()), false);
+    juce::Graphics g(background);
     juce::ColourGradient gradient (coldgreen, 20.0f, 20.0f, darkpink, 400.0f, 400.0f, false);
     g.setGradientFill(gradient);
     g.fillAll();
 
-    g.setColour(juce::Colours::cadetblue);
-    g.setFont(15.0f);
-
-}
-
-void LaplandAudioProcessorEditor::resized()
-{
     const auto SliderSide = 180;
     const auto padding = 10;
     const auto sliderStartX = 10;
@@ -112,6 +120,40 @@ void LaplandAudioProcessorEditor::resized()
     releaseLabel.setBounds(releaseSlider.getX(), attackSlider.getY() - 15, sliderWidth, 20);
 
     imgComponent.setBounds(-10.0f, 0, SliderSide + 90, SliderSide + 25);
+
+    analyser.setBounds(10, ADSR_Y + sliderHeight + padding, getWidth() - 20, getHeight() - (ADSR_Y + sliderHeight + padding) - 27);
+
+    telemetryLabel.setBounds(0, getHeight() - 22, getWidth(), 20);
+}
+
+void LaplandAudioProcessorEditor::timerCallback()
+{
+    const auto count = audioProcessor.getTelemetry().readForEditor(telemetryReports.data(), (int)telemetryReports.size());
+    if (count == 0) { return; }
+
+    //load over everything rendered since the last tick, peak of the worst single block
+    auto renderTime = 0.0f;
+    auto realTime = 0.0f;
+    auto peak = 0.0f;
+
+    for (int i = 0; i < count; ++i)
+    {
+        const auto& report = telemetryReports[(size_t)i];
+        renderTime += report.renderMicroseconds;
+        realTime += report.deadlineMicroseconds;
+        if (report.deadlineMicroseconds > 0.0f)
+            peak = juce::jmax(peak, report.renderMicroseconds / report.deadlineMicroseconds);
+    }
+
+    const auto totals = audioProcessor.getTelemetry().getTotals();
+
+    telemetryLabel.setText("CPU " + juce::String(realTime > 0.0f ? 100.0f * renderTime / realTime : 0.0f, 1) + "%"
+                           + "  peak " + juce::String(100.0f * peak, 0) + "%"
+                           + "  voices " + juce::String(telemetryReports[(size_t)count - 1].activeVoices)
+                           + "  near " + juce::String((juce::int64)totals.nearMisses)
+                           + "  missed " + juce::String((juce::int64)totals.deadlineMisses)
+                           + "  stolen " + juce::String((juce::int64)totals.voicesStolen),
+                           juce::dontSendNotification);
 }
 
 void LaplandAudioProcessorEditor::setSlider(juce::Slider& slider, float min_value, float max_value, float valueToSet)
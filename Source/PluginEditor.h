@@ -10,11 +10,13 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "SpectrumAnalyser.h"
 
 //==============================================================================
 /**
 */
-class LaplandAudioProcessorEditor : public juce::AudioProcessorEditor
+class LaplandAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                    private juce::Timer
 {
 public:
     LaplandAudioProcessorEditor(LaplandAudioProcessor&);
@@ -27,6 +29,8 @@ public:
     void setLabel(juce::Label& label);
 
 private:
+    void timerCallback() override;
+
     juce::Slider keyFreqSlider;
     juce::Slider cleaningNoiseSlider;
 
@@ -48,6 +52,12 @@ private:
 
     juce::Label volumeLabel{ "Volume", "Volume" };
 
+    SpectrumAnalyser analyser;
+    juce::Image background; //the gradient, drawn once per size rather than on every repaint
+
+    juce::Label telemetryLabel{ "Telemetry", {} };
+    std::array<BlockTelemetry, PerformanceTelemetry::ringSize> telemetryReports;
+
     using Attachment = juce::AudioProcessorValueTreeState::SliderAttachment;
 
     std::unique_ptr<Attachment> keyFreqSliderAttch;
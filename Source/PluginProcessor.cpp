@@ -7,7 +7,9 @@
 */
 
 #include "PluginProcessor.h"
+#if ! LAPLAND_HEADLESS
 #include "PluginEditor.h"
+#endif
 
 //==============================================================================
 LaplandAudioProcessor::LaplandAudioProcessor()
@@ -19,15 +21,12 @@ LaplandAudioProcessor::LaplandAudioProcessor()
 #endif
         .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
-    ), apvts(*this, nullptr), bpFilter(juce::dsp::IIR::Coefficients<float>::makeLowPass(44100, 20000.0f, 0.1))
+    ), apvts(*this, nullptr)
 #endif
 {
     
     lapland.addSound(new SynthSound);
-    for (int i = 0; i < 22; i++)
-    {
-        lapland.addVoice(new SynthVoice());
-    }
+    //no voices yet, prepareToPlay creates as many as the Polyphony parameter asks for
     
 
     juce::NormalisableRange<float> keyFreqRange(20.0f, 20000.0f, 0.1f);
@@ -40,6 +39,30 @@ LaplandAudioProcessor::LaplandAudioProcessor()
 
     juce::NormalisableRange<float> volumeRange(0.0f, 1.0f, 0.001f);
 
+    juce::NormalisableRange<float> noiseModeRange(0.0f, 2.0f, 1.0f);
+    juce::NormalisableRange<float> filterModeRange(0.0f, 4.0f, 1.0f);
+
+    juce::NormalisableRange<float> polyphonyRange(1.0f, (float)LaplandSynthesiser::maxPolyphony, 1.0f);
+    juce::NormalisableRange<float> voiceStealingRange(0.0f, 2.0f, 1.0f);
+    juce::NormalisableRange<float> renderThreadsRange(1.0f, (float)RenderWorkerPool::maxThreads, 1.0f);
+
+    juce::NormalisableRange<float> oversamplingRange(0.0f, 2.0f, 1.0f);
+
+    juce::NormalisableRange<float> partialsRange(1.0f, (float)ResonatorBank::maxPartials, 1.0f);
+    juce::NormalisableRange<float> partialTiltRange(0.0f, 2.0f, 0.01f);
+    juce::NormalisableRange<float> partialDampingRange(0.0f, 1.0f, 0.01f);
+
+    juce::NormalisableRange<float> silenceFloorRange(-150.0f, -60.0f, 1.0f);
+
+    juce::NormalisableRange<float> stereoModeRange(0.0f, 1.0f, 1.0f);
+    juce::NormalisableRange<float> widthRange(0.0f, 1.0f, 0.01f);
+
+    juce::NormalisableRange<float> bendRangeRange(0.0f, 48.0f, 1.0f);
+    juce::NormalisableRange<float> modControllerRange(0.0f, 127.0f, 1.0f);
+    juce::NormalisableRange<float> modSourceRange(0.0f, (float)(ModulationMatrix::numSources - 1), 1.0f);
+    juce::NormalisableRange<float> modDestinationRange(0.0f, (float)(ModulationMatrix::numDestinations - 1), 1.0f);
+    juce::NormalisableRange<float> modAmountRange(-1.0f, 1.0f, 0.01f);
+
     apvts.createAndAddParameter("KeyFreq", "Key Frequency", "KeyFreq", keyFreqRange, 20.0f, nullptr, nullptr);
     apvts.createAndAddParameter("CleaningLevel", "Noise Cleaning Level", "CleaningLevel", noiseCleaningRange, 1000.0f, nullptr, nullptr);
 
@@ -49,10 +72,76 @@ LaplandAudioProcessor::LaplandAudioProcessor()
     apvts.createAndAddParameter("Release", "Release", "Release", releaseRange, 0.6f, nullptr, nullptr);
 
     apvts.createAndAddParameter("Volume", "Volume", "Volume", volumeRange, 0.06f, nullptr, nullptr);
+
+    apvts.createAndAddParameter("NoiseMode", "Noise Mode", "NoiseMode", noiseModeRange, 0.0f,
+        [](float value) { return juce::StringArray{ "Per Voice", "Shared", "Shared Decorrelated" }[(int)value]; },
+        nullptr, false, true, true);
+    apvts.createAndAddParameter("FilterMode", "Filter Mode", "FilterMode", filterModeRange, 0.0f,
+        [](float value) { return juce::StringArray{ "Low-pass", "SVF Low-pass", "SVF Band-pass", "SVF High-pass", "Resonator Bank" }[(int)value]; },
+        nullptr, false, true, true);
+
+    apvts.createAndAddParameter("Polyphony", "Polyphony", "Voices", polyphonyRange, 22.0f, nullptr, nullptr, false, true, true);
+    apvts.createAndAddParameter("VoiceStealing", "Voice Stealing", "VoiceStealing", voiceStealingRange, 0.0f,
+        [](float value) { return juce::StringArray{ "Oldest", "Quietest", "Lowest Priority" }[(int)value]; },
+        nullptr, false, true, true);
+    apvts.createAndAddParameter("RenderThreads", "Render Threads", "Threads", renderThreadsRange, 1.0f, nullptr, nullptr, false, true, true);
+
+    apvts.createAndAddParameter("Oversampling", "Oversampling", "Oversampling", oversamplingRange, 0.0f,
+        [](float value) { return juce::StringArray{ "Off", "2x", "4x" }[(int)value]; },
+        nullptr, false, true, true);
+
+    apvts.createAndAddParameter("Partials", "Partials", "Partials", partialsRange, 16.0f, nullptr, nullptr, false, true, true);
+    apvts.createAndAddParameter("PartialTilt", "Partial Tilt", "PartialTilt", partialTiltRange, 1.0f, nullptr, nullptr);
+    apvts.createAndAddParameter("PartialDamping", "Partial Damping", "PartialDamping", partialDampingRange, 0.5f, nullptr, nullptr);
+
+    apvts.createAndAddParameter("SilenceFloor", "Silence Floor", "dB", silenceFloorRange, -120.0f, nullptr, nullptr);
+
+    apvts.createAndAddParameter("StereoMode", "Stereo Mode", "StereoMode", stereoModeRange, 0.0f,
+        [](float value) { return juce::StringArray{ "Independent", "Mono + Pan" }[(int)value]; },
+        nullptr, false, true, true);
+    apvts.createAndAddParameter("Width", "Width", "Width", widthRange, 0.5f, nullptr, nullptr);
+
+    apvts.createAndAddParameter("BendRange", "Pitch Bend Range", "st", bendRangeRange, 2.0f, nullptr, nullptr, false, true, true);
+    apvts.createAndAddParameter("ModController", "Mod Controller", "CC", modControllerRange, 2.0f, nullptr, nullptr, false, true, true);
+
+    //mod wheel opens the filter, pressure adds level, slide adds resonance
+    const ModulationMatrix::Slot defaultSlots[] = { { ModulationMatrix::modWheel, ModulationMatrix::cutoff, 0.25f },
+                                                    { ModulationMatrix::pressure, ModulationMatrix::gain, 0.25f },
+                                                    { ModulationMatrix::slide, ModulationMatrix::resonance, 0.25f } };
+
+    for (int slot = 0; slot < ModulationMatrix::numSlots; ++slot)
+    {
+        const auto number = juce::String(slot + 1);
+
+        apvts.createAndAddParameter(ParameterSnapshot::modSourceIDs[slot], "Mod " + number + " Source", "ModSource", modSourceRange, (float)defaultSlots[slot].source,
+            [](float value) { return juce::StringArray{ "Off", "Pitch Bend", "Pressure", "Slide", "Mod Wheel", "Controller" }[(int)value]; },
+            nullptr, false, true, true);
+        apvts.createAndAddParameter(ParameterSnapshot::modDestinationIDs[slot], "Mod " + number + " Destination", "ModDestination", modDestinationRange, (float)defaultSlots[slot].destination,
+            [](float value) { return juce::StringArray{ "Cutoff", "Resonance", "Gain", "Envelope Time" }[(int)value]; },
+            nullptr, false, true, true);
+        apvts.createAndAddParameter(ParameterSnapshot::modAmountIDs[slot], "Mod " + number + " Amount", "ModAmount", modAmountRange, defaultSlots[slot].amount, nullptr, nullptr);
+    }
+
+    parameterAtomics.attachTo(apvts);
+
+    //set LAPLAND_STATS_FILE to an absolute path to get a CSV line per block, for profiling outside a DAW.
+    //A host's working directory is anyone's guess, so relative paths are refused
+    const auto statsFile = juce::SystemStats::getEnvironmentVariable("LAPLAND_STATS_FILE", {});
+    if (statsFile.isNotEmpty())
+    {
+        if (juce::File::isAbsolutePath(statsFile))
+            telemetry.startDump(PerformanceTelemetry::getInstanceDumpFile(juce::File(statsFile)));
+        else
+            DBG("LAPLAND_STATS_FILE must be an absolute path, no stats are written");
+    }
+
+    //polls the pool update flag, posting a message from the audio thread could allocate or lock
+    startTimerHz(20);
 }
 
 LaplandAudioProcessor::~LaplandAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -90,61 +179,152 @@ bool LaplandAudioProcessor::isMidiEffect() const
 
 double LaplandAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    //the release stage is the voices' only tail, the filters ring before the envelope and not after it.
+    //Envelope Time modulation can stretch it, so allow for the longest the routing permits.
+    //In panned mono the decorrelator rings on after the voices
+    if (parameterAtomics.release == nullptr) { return 0.0; }
+
+    const auto snapshot = parameterAtomics.load();
+    return (double)snapshot.release * (double)snapshot.getModulationMatrix().getMaxEnvelopeTimeScale()
+           + (snapshot.stereoMode == 1 ? StereoDecorrelator::tailSeconds : 0.0);
 }
 
 int LaplandAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    //some hosts don't cope with 0 programs, so without a bank there is still the one default
+    return juce::jmax(1, presetBank->getNumPresets());
 }
 
 int LaplandAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram;
 }
 
 void LaplandAudioProcessor::setCurrentProgram(int index)
 {
+    //parameters the bank doesn't store keep their current value
+    auto snapshot = parameterAtomics.load();
+    if (!presetBank->readPreset(index, snapshot))
+        return;
+
+    currentProgram = index;
+    applyParameterSet(snapshot);
 }
 
 const juce::String LaplandAudioProcessor::getProgramName(int index)
 {
-    return {};
+    return presetBank->getNumPresets() > 0 ? presetBank->getName(index) : juce::String("Default");
 }
 
 void LaplandAudioProcessor::changeProgramName(int index, const juce::String& newName)
 {
+    //the bank is mapped read-only, programs are renamed by rewriting the bank file
 }
 
 //==============================================================================
 void LaplandAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     lapland.setCurrentPlaybackSampleRate(sampleRate);
+    growVoicePool((int)parameterAtomics.polyphony->load(std::memory_order_relaxed));
+
+    prepareRenderThreads(samplesPerBlock, getRenderThreadsFor((int)parameterAtomics.renderThreads->load(std::memory_order_relaxed)));
+    lapland.resetFilterStates(); //the voices are reset below, their bank filters start from silence too
+    lapland.resetNoteOnCount(); //so a seeded render repeats from here
+    sharedNoise.prepare(getTotalNumOutputChannels(), samplesPerBlock);
+    if (noiseIsSeeded) { sharedNoise.setSeed(noiseSeed); }
+    filterTable.build(sampleRate);
+    oversampledFilterTables[0].build(sampleRate * 2.0);
+    oversampledFilterTables[1].build(sampleRate * 4.0);
+    decorrelator.prepare(sampleRate);
+    analyserFifo.setSampleRate(sampleRate);
+
+    for (auto* voice : synthVoices)
+    {
+        voice->prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels(), scratchArena, sharedNoise, filterTable, oversampledFilterTables);
+    }
 
-    juce::dsp::ProcessSpec spec;
-    //lastSampleRate = sampleRate;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = getTotalNumOutputChannels();
+    //the voices were just reset, so push every parameter on the next block
+    snapshotIsStale = true;
+}
 
-    /*
-    
-    bpFilter.prepare(spec);
-    gain.prepare(spec);
-    bpFilter.reset();
-    updateKeyFreq(20.0);
-    updateVolume();
-    */
-    for (int i = 0; i < lapland.getNumVoices(); i++)
+void LaplandAudioProcessor::growVoicePool(int numVoices)
+{
+    numVoices = juce::jmin(numVoices, LaplandSynthesiser::maxPolyphony);
+
+    while (synthVoices.size() < numVoices)
     {
-        if (auto voice = dynamic_cast<SynthVoice*>(lapland.getVoice(i))) //returns Syntheseiser Voice,
-        {
-            voice->prepareToPlay(sampleRate, samplesPerBlock, getTotalNumOutputChannels());
-        }
+        auto* voice = static_cast<SynthVoice*>(lapland.addVoice(new SynthVoice(synthVoices.size())));
+        if (noiseIsSeeded) { voice->updateNoiseSeed(noiseSeed); }
+        voice->updateVoiceBank(voiceBankEnabled);
+        synthVoices.add(voice);
     }
 
-    updateVolume();
+    sharedNoise.setNumVoices(synthVoices.size());
+}
+
+int LaplandAudioProcessor::getRenderThreadsFor(int requestedThreads) noexcept
+{
+    return juce::jlimit(1, juce::jmin(juce::jmax(1, juce::SystemStats::getNumCpus()), RenderWorkerPool::maxThreads), requestedThreads);
+}
+
+void LaplandAudioProcessor::prepareRenderThreads(int samplesPerBlock, int numThreads)
+{
+    //helpers only exist while more than one render thread is asked for, the default of one starts none
+    lapland.prepare(getTotalNumOutputChannels(), samplesPerBlock, numThreads - 1);
+    //one extra row for the envelope, one slot per render thread
+    //oversampled notes render a block in slices, each slice needs room for factor times its samples
+    scratchArena.prepare(getTotalNumOutputChannels() + 1, juce::jmax(samplesPerBlock, SynthVoice::maxOversampling), lapland.getMaxRenderThreads());
+}
+
+void LaplandAudioProcessor::timerCallback()
+{
+    if (voicePoolUpdatePending.exchange(false, std::memory_order_acquire))
+        updateVoicePool();
+}
+
+void LaplandAudioProcessor::updateVoicePool()
+{
+    const auto numVoices = juce::jmin((int)parameterAtomics.polyphony->load(std::memory_order_relaxed), LaplandSynthesiser::maxPolyphony);
+    const auto numThreads = getRenderThreadsFor((int)parameterAtomics.renderThreads->load(std::memory_order_relaxed));
+    if ((numVoices <= synthVoices.size() && numThreads == lapland.getMaxRenderThreads()) || getSampleRate() <= 0.0) { return; }
+
+    //the audio thread is held off while the pool, the helper threads and the bookkeeping change, sounding voices carry on afterwards
+    suspendProcessing(true);
+
+    const auto firstNewVoice = synthVoices.size();
+    growVoicePool(numVoices);
+    prepareRenderThreads(getBlockSize(), numThreads);
+
+    for (int i = firstNewVoice; i < synthVoices.size(); ++i)
+    {
+        synthVoices.getUnchecked(i)->prepareToPlay(getSampleRate(), getBlockSize(), getTotalNumOutputChannels(), scratchArena, sharedNoise, filterTable, oversampledFilterTables);
+    }
+
+    //the new voices need every parameter, and RenderThreads is clamped to the helpers that now exist
+    snapshotIsStale = true;
+
+    suspendProcessing(false);
+}
+
+void LaplandAudioProcessor::setNoiseSeed(juce::int64 seed)
+{
+    noiseSeed = seed;
+    noiseIsSeeded = true;
+
+    for (auto* voice : synthVoices)
+    {
+        voice->updateNoiseSeed(seed);
+    }
+}
+
+void LaplandAudioProcessor::setVoiceBankEnabled(bool shouldUseBank)
+{
+    voiceBankEnabled = shouldUseBank;
+
+    for (auto* voice : synthVoices)
+    {
+        voice->updateVoiceBank(shouldUseBank);
+    }
 }
 
 void LaplandAudioProcessor::releaseResources()
@@ -179,86 +359,151 @@ bool LaplandAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) c
 }
 #endif
 
-void LaplandAudioProcessor::updateNoiseCleaningLevel()
+void LaplandAudioProcessor::updateNoiseCleaningLevel(float cleaningLevel)
 {
-    float cleaningLevel = *apvts.getRawParameterValue("CleaningLevel");
+    coefficientUpdates += usedVoices;
+
+    for (int i = 0; i < usedVoices; ++i)
+    {
+        synthVoices.getUnchecked(i)->updateNoiseCleaningLevel(cleaningLevel);
+    }
+}
 
-    *bpFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(lastSampleRate, lastKeyFreq, cleaningLevel);
+void LaplandAudioProcessor::updateADSR(float attack, float decay, float sustain, float release)
+{
+    for (int i = 0; i < usedVoices; ++i)
+    {
+        synthVoices.getUnchecked(i)->updateADSR(attack, decay, sustain, release);
+    }
+}
 
-    for (int i = 0; i < lapland.getNumVoices(); ++i)
+void LaplandAudioProcessor::updateVolume(float volume)
+{
+    for (int i = 0; i < usedVoices; ++i)
     {
-        if (auto voice = dynamic_cast<SynthVoice*>(lapland.getVoice(i)))
-        {
-            voice->updateNoiseCleaningLevel(cleaningLevel);
-            //for all voices
-        }
+        synthVoices.getUnchecked(i)->updateVolume(volume);
     }
 }
 
-void LaplandAudioProcessor::updateKeyFreq(double midiKeyFreq)
+void LaplandAudioProcessor::updateFilterMode(int filterMode)
 {
-    /*
-    float keyfreq = *apvts.getRawParameterValue("KeyFreq");
-    */
-    lastKeyFreq = float(midiKeyFreq);
-    //float cleaningLevel = *apvts.getRawParameterValue("CleaningLevel"); //redundant
+    for (int i = 0; i < usedVoices; ++i)
+    {
+        synthVoices.getUnchecked(i)->updateFilterMode(filterMode);
+    }
 
-    //*bpFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(lastSampleRate, lastKeyFreq, cleaningLevel);
+    lapland.resetFilterStates();
+}
 
-    for (int i = 0; i < lapland.getNumVoices(); ++i)
+void LaplandAudioProcessor::updateOversampling(int oversamplingChoice)
+{
+    for (int i = 0; i < usedVoices; ++i)
     {
-        if (auto voice = dynamic_cast<SynthVoice*>(lapland.getVoice(i)))
-        {
-            voice->updateKeyFreq(lastKeyFreq);
-            //if voice is NOT busy
-        }
+        synthVoices.getUnchecked(i)->updateOversampling(1 << oversamplingChoice);
     }
 }
 
-void LaplandAudioProcessor::updateADSR()
+void LaplandAudioProcessor::updatePartials(int numPartials, float tilt, float damping)
 {
-    /*
-    
-    adsrParameters.attack = *apvts.getRawParameterValue("Attack");
-    adsrParameters.decay = *apvts.getRawParameterValue("Decay");
-    adsrParameters.sustain = *apvts.getRawParameterValue("Sustain");
-    adsrParameters.release = *apvts.getRawParameterValue("Release");
+    for (int i = 0; i < usedVoices; ++i)
+    {
+        synthVoices.getUnchecked(i)->updatePartials(numPartials, tilt, damping);
+    }
+}
 
-    adsr.setParameters(adsrParameters);
-    */
+void LaplandAudioProcessor::updateSilenceFloor(float decibels)
+{
+    for (int i = 0; i < usedVoices; ++i)
+    {
+        synthVoices.getUnchecked(i)->updateSilenceFloor(decibels);
+    }
+}
 
+void LaplandAudioProcessor::updateStereo(int stereoMode, float width)
+{
+    for (int i = 0; i < usedVoices; ++i)
+    {
+        synthVoices.getUnchecked(i)->updateStereo(stereoMode == 1, width);
+    }
 
-    auto& attack = *apvts.getRawParameterValue("Attack");
-    auto& decay = *apvts.getRawParameterValue("Decay");
-    auto& sustain = *apvts.getRawParameterValue("Sustain");
-    auto& release = *apvts.getRawParameterValue("Release");
+    //the filter states of the right channel are not kept up in panned mode, start both modes clean.
+    //Only on a mode switch: Width alone, or a push of every parameter, must not cut the ringing filters
+    if ((stereoMode == 1) != lapland.isPannedMono())
+    {
+        lapland.setPannedMono(stereoMode == 1);
+        lapland.resetFilterStates();
+        decorrelator.reset(); //an old tail left when panned mono was switched off must not come back with it
+    }
+}
 
-    for (int i = 0; i < lapland.getNumVoices(); ++i)
+void LaplandAudioProcessor::updateModulation(const ModulationMatrix& matrix)
+{
+    for (int i = 0; i < usedVoices; ++i)
     {
-        if (auto voice = dynamic_cast<SynthVoice*>(lapland.getVoice(i)))
-        {
-            voice->updateADSR(attack.load(), decay.load(), sustain.load(), release.load());
-        }
+        synthVoices.getUnchecked(i)->updateModulation(matrix);
     }
 }
 
-void LaplandAudioProcessor::updateVolume()
+void LaplandAudioProcessor::pushParameterChanges(const ParameterSnapshot& snapshot)
 {
-    float volume = *apvts.getRawParameterValue("Volume");
+    auto pushAll = snapshotIsStale;
+    snapshotIsStale = false;
 
-    for (int i = 0; i < lapland.getNumVoices(); ++i)
+    //the updates below only reach the used voices, so newly used ones need everything
+    if (pushAll || snapshot.polyphony != lastSnapshot.polyphony)
     {
-        if (auto voice = dynamic_cast<SynthVoice*>(lapland.getVoice(i)))
-        {
-            voice->updateVolume(volume);
-        }
+        pushAll = pushAll || snapshot.polyphony > usedVoices;
+        lapland.setPolyphony(snapshot.polyphony);
+        usedVoices = lapland.getPolyphony();
+
+        //more voices than were ever asked for, the pool can only grow off the audio thread
+        if (snapshot.polyphony > synthVoices.size())
+            voicePoolUpdatePending.store(true, std::memory_order_release);
     }
 
-    //gain.setGainLinear(volume);
+    lapland.setStealingPolicy((LaplandSynthesiser::StealingPolicy)snapshot.stealingPolicy);
+    lapland.setNumRenderThreads(snapshot.renderThreads);
+
+    //helper threads are started and stopped off the audio thread too
+    if (getRenderThreadsFor(snapshot.renderThreads) != lapland.getMaxRenderThreads())
+        voicePoolUpdatePending.store(true, std::memory_order_release);
+
+    if (pushAll || snapshot.adsrDiffersFrom(lastSnapshot))
+        updateADSR(snapshot.attack, snapshot.decay, snapshot.sustain, snapshot.release);
+
+    if (pushAll || snapshot.cleaningLevel != lastSnapshot.cleaningLevel)
+        updateNoiseCleaningLevel(snapshot.cleaningLevel);
+
+    if (pushAll || snapshot.volume != lastSnapshot.volume)
+        updateVolume(snapshot.volume);
+
+    if (pushAll || snapshot.filterMode != lastSnapshot.filterMode)
+        updateFilterMode(snapshot.filterMode);
+
+    if (pushAll || snapshot.oversampling != lastSnapshot.oversampling)
+        updateOversampling(snapshot.oversampling);
+
+    if (pushAll || snapshot.partialsDifferFrom(lastSnapshot))
+        updatePartials(snapshot.partials, snapshot.partialTilt, snapshot.partialDamping);
+
+    if (pushAll || snapshot.silenceFloor != lastSnapshot.silenceFloor)
+        updateSilenceFloor(snapshot.silenceFloor);
+
+    if (pushAll || snapshot.stereoMode != lastSnapshot.stereoMode || snapshot.width != lastSnapshot.width)
+        updateStereo(snapshot.stereoMode, snapshot.width);
+
+    if (pushAll || snapshot.modulationDiffersFrom(lastSnapshot))
+        updateModulation(snapshot.getModulationMatrix());
+
+    sharedNoise.setMode((SharedNoiseSource::Mode)snapshot.noiseMode);
+
+    lastSnapshot = snapshot;
 }
 
 void LaplandAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    const ScopedAllocationTrap allocationTrap;
+    const auto blockStartTicks = juce::Time::getHighResolutionTicks();
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -266,83 +511,92 @@ void LaplandAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce:
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    updateADSR();
-    updateNoiseCleaningLevel();
-    updateVolume();
+    //during a program change the whole new set comes from the switch, never half of it from the parameters
+    ParameterSnapshot snapshot;
+    if (!programSwitch.read(snapshot))
+        snapshot = parameterAtomics.load();
 
-    lapland.renderNextBlock(buffer, midiMessages, 0, buffer.getNumSamples());
+    pushParameterChanges(snapshot);
 
-    juce::dsp::AudioBlock<float> block(buffer);
-
-   
-    for (const auto& meta : midiMessages)
+    //nothing sounding and nothing to start: the output is already cleared above, skip the noise and the voices
+    const auto rendering = !midiMessages.isEmpty() || lapland.getNumActiveVoices() > 0;
+    if (rendering)
     {
-        const auto msg = meta.getMessage();
-
-        const auto timestamp = meta.samplePosition;
-
-        auto mtof = msg.getMidiNoteInHertz(msg.getNoteNumber());
-
-        for (int i = 0; i < lapland.getNumVoices(); ++i)
-        {
-            if (auto voice = dynamic_cast<SynthVoice*>(lapland.getVoice(i)))
-            {
-                if (voice->isBusy() == false) {
-                    voice->updateKeyFreq(mtof);
-                } 
-            }
-        }
+        sharedNoise.generate(buffer.getNumSamples(), SynthVoice::noiseLevel);
+        lapland.renderBlock(buffer, midiMessages, 0, buffer.getNumSamples());
     }
-    /*
-    
-    for (const auto& meta : midiMessages)
-    {
-        const auto msg = meta.getMessage();
 
-        const auto timestamp = meta.samplePosition;
+    //panned mono voices are fully correlated, the bus gets its width back here for one all-pass chain in total.
+    //Once the voices are done it runs on silence until its own tail has rung out
+    if (lastSnapshot.stereoMode == 1 && buffer.getNumChannels() >= 2 && (rendering || decorrelator.isRinging()))
+        decorrelator.process(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples(), lastSnapshot.width);
 
-        auto mtof = msg.getMidiNoteInHertz(msg.getNoteNumber());
+    analyserFifo.push(buffer);
 
+    const auto noteCounters = lapland.takeNoteCounters();
 
-        if (msg.isNoteOff())
-        {
-            adsr.noteOff();
-        }
-        else {
-            adsr.noteOn();
-        }
+    BlockTelemetry report;
+    report.renderMicroseconds = (float)(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - blockStartTicks) * 1.0e6);
+    report.deadlineMicroseconds = getSampleRate() > 0.0 ? (float)(buffer.getNumSamples() * 1.0e6 / getSampleRate()) : 0.0f;
+    report.activeVoices = lapland.getNumActiveVoices();
+    report.notesStarted = noteCounters.notesStarted;
+    report.voicesStolen = noteCounters.voicesStolen;
+    report.coefficientUpdates = coefficientUpdates + noteCounters.notesStarted; //every note start refreshes its voice
+    coefficientUpdates = 0;
 
-        updateKeyFreq(mtof);
-    }
-    */
-    //gain.process(juce::dsp::ProcessContextReplacing<float>(block));
-    //adsr.applyEnvelopeToBuffer(buffer, 0, buffer.getNumSamples());
-    //bpFilter.process(juce::dsp::ProcessContextReplacing<float>(block));
+    telemetry.publish(report);
 }
 
 //==============================================================================
 bool LaplandAudioProcessor::hasEditor() const
 {
+#if LAPLAND_HEADLESS
+    return false; //the command line tools build without the GUI sources
+#else
     return true; // (change this to false if you choose to not supply an editor)
+#endif
 }
 
 juce::AudioProcessorEditor* LaplandAudioProcessor::createEditor()
 {
+#if LAPLAND_HEADLESS
+    return nullptr;
+#else
     return new LaplandAudioProcessorEditor(*this);
+#endif
 }
 
 //==============================================================================
 void LaplandAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    PresetFormat::writeState(destData, parameterAtomics.load(), currentProgram);
 }
 
 void LaplandAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    auto snapshot = parameterAtomics.load();
+    auto program = currentProgram;
+
+    if (!PresetFormat::readState(data, (size_t)juce::jmax(0, sizeInBytes), snapshot, program))
+        return;
+
+    //the state may come from a session saved with a bigger bank, or from a damaged file
+    currentProgram = juce::jlimit(0, getNumPrograms() - 1, program);
+    applyParameterSet(snapshot);
+}
+
+void LaplandAudioProcessor::applyParameterSet(const ParameterSnapshot& snapshot)
+{
+    programSwitch.publish(snapshot);
+
+    auto values = snapshot;
+    values.forEachValue([this](const char* parameterID, float& value)
+    {
+        if (auto* parameter = apvts.getParameter(parameterID))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    });
+
+    programSwitch.settle();
 }
 
 //==============================================================================
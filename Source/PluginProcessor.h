@@ -11,12 +11,24 @@
 #include <JuceHeader.h>
 #include "SynthSound.h"
 #include "SynthVoice.h"
+#include "LaplandSynthesiser.h"
+#include "ScratchArena.h"
+#include "SharedNoiseSource.h"
+#include "FilterCoefficientTable.h"
+#include "AllocationTrap.h"
+#include "ParameterSnapshot.h"
+#include "PerformanceTelemetry.h"
+#include "PresetFormat.h"
+#include "ProgramSwitch.h"
+#include "StereoDecorrelator.h"
+#include "AnalyserFifo.h"
 
 
 //==============================================================================
 /**
 */
-class LaplandAudioProcessor : public juce::AudioProcessor
+class LaplandAudioProcessor : public juce::AudioProcessor,
+                              private juce::Timer
 {
 public:
     //==============================================================================
@@ -31,9 +43,14 @@ public:
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 #endif
 
-    void updateKeyFreq(double midiKeyFreq);
-    void updateNoiseCleaningLevel();
-    void updateVolume();
+    void updateNoiseCleaningLevel(float cleaningLevel);
+    void updateVolume(float volume);
+    void updateFilterMode(int filterMode);
+    void updateOversampling(int oversamplingChoice);
+    void updatePartials(int numPartials, float tilt, float damping);
+    void updateSilenceFloor(float decibels);
+    void updateStereo(int stereoMode, float width);
+    void updateModulation(const ModulationMatrix& matrix);
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     //==============================================================================
@@ -59,23 +76,59 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
-    void updateADSR();
+    void updateADSR(float attack, float decay, float sustain, float release);
 
     juce::AudioProcessorValueTreeState apvts;
 
+    //reproducible output: the same seed, parameters and MIDI render bit identical audio. Call before prepareToPlay
+    void setNoiseSeed(juce::int64 seed);
+
+    //verification only: false renders the low-pass voices one at a time instead of through the VoiceBank,
+    //the scalar reference the bank has to match. Call before prepareToPlay
+    void setVoiceBankEnabled(bool shouldUseBank);
+
+    PerformanceTelemetry& getTelemetry() noexcept { return telemetry; }
+    AnalyserFifo& getAnalyserFifo() noexcept { return analyserFifo; }
+
 private:
-    juce::Synthesiser lapland;
+    LaplandSynthesiser lapland;
+    ScratchArena scratchArena; //render memory for all voices, sized in prepareToPlay
+    SharedNoiseSource sharedNoise; //noise block all voices filter when NoiseMode is shared
+    FilterCoefficientTable filterTable; //low-pass coefficients per note and cleaning level
+    FilterCoefficientTable oversampledFilterTables[2]; //the same at 2x and 4x the host rate, for oversampled notes
+    StereoDecorrelator decorrelator; //mix bus width for the panned mono mode
+
+    juce::Array<SynthVoice*> synthVoices; //same voices as in lapland, kept typed so updates need no dynamic_cast
+    int usedVoices{ 1 }; //the first usedVoices entries of synthVoices, follows the Polyphony parameter
+
+    //the pool holds as many voices as Polyphony has asked for so far, a low polyphony instance stays small
+    void growVoicePool(int numVoices);
+    void timerCallback() override; //picks up voicePoolUpdatePending on the message thread
+    void updateVoicePool(); //Polyphony or RenderThreads changed while playing, grows the pool and sets the helpers
+    std::atomic<bool> voicePoolUpdatePending{ false }; //set by processBlock, which must not post messages itself
+
+    static int getRenderThreadsFor(int requestedThreads) noexcept; //RenderThreads limited to the machine
+    void prepareRenderThreads(int samplesPerBlock, int numThreads);
+
+    ParameterAtomics parameterAtomics;
+    ParameterSnapshot lastSnapshot;
+    bool snapshotIsStale{ true };
 
-    juce::dsp::ProcessorDuplicator <juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients <float>> bpFilter;
+    void pushParameterChanges(const ParameterSnapshot& snapshot);
+    void applyParameterSet(const ParameterSnapshot& snapshot);
 
-    float lastSampleRate;
-    float lastKeyFreq;
+    juce::SharedResourcePointer<PresetBank> presetBank; //mapped once and shared by every instance in the process
+    ProgramSwitch programSwitch;
+    int currentProgram{ 0 };
 
+    juce::int64 noiseSeed{ 0 };
+    bool noiseIsSeeded{ false };
+    bool voiceBankEnabled{ true };
 
+    PerformanceTelemetry telemetry;
+    AnalyserFifo analyserFifo; //output for the editor's analyser, only fed while one is open
+    int coefficientUpdates{ 0 }; //voice filter refreshes caused by parameter changes in the current block
 
-    juce::ADSR adsr;
-    juce::ADSR::Parameters adsrParameters;
-    juce::dsp::Gain <float> gain;
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LaplandAudioProcessor)
 };
\ No newline at end of file
@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+    PresetFormat.cpp
+    Created: 18 Oct 2026 9:02:37pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#include "PresetFormat.h"
+
+namespace
+{
+    constexpr size_t stateHeaderSize = 12;
+    constexpr size_t bankHeaderSize = 12;
+    constexpr size_t valueSize = 8;
+
+    float readFloat(const char* data) noexcept
+    {
+        const auto bits = juce::ByteOrder::littleEndianInt(data);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    //overlays every (hash, value) pair found in the file onto the matching snapshot field
+    template <typename ValueAt>
+    void overlayValues(ParameterSnapshot& snapshot, const char* hashes, size_t hashStride, int numValues, ValueAt valueAt) noexcept
+    {
+        snapshot.forEachValue([&](const char* parameterID, float& field)
+        {
+            const auto hash = PresetFormat::hashParameterID(parameterID);
+
+            for (int i = 0; i < numValues; ++i)
+            {
+                if (juce::ByteOrder::littleEndianInt(hashes + (size_t)i * hashStride) == hash)
+                {
+                    field = valueAt(i);
+                    return;
+                }
+            }
+        });
+    }
+}
+
+juce::uint32 PresetFormat::hashParameterID(const char* parameterID) noexcept
+{
+    juce::uint32 hash = 2166136261u;
+
+    for (auto* c = parameterID; *c != 0; ++c)
+        hash = (hash ^ (juce::uint8)*c) * 16777619u;
+
+    return hash;
+}
+
+bool PresetFormat::isState(const void* data, size_t sizeInBytes) noexcept
+{
+    return data != nullptr && sizeInBytes >= stateHeaderSize
+        && juce::ByteOrder::littleEndianInt(data) == stateMagic;
+}
+
+void PresetFormat::writeState(juce::MemoryBlock& destination, const ParameterSnapshot& snapshot, int program)
+{
+    juce::MemoryOutputStream stream(destination, false);
+
+    stream.writeInt((int)stateMagic);
+    stream.writeShort((short)version);
+    stream.writeShort((short)program);
+    stream.writeShort((short)ParameterSnapshot::numValues);
+    stream.writeShort(0);
+
+    auto values = snapshot;
+    values.forEachValue([&](const char* parameterID, float& value)
+    {
+        stream.writeInt((int)hashParameterID(parameterID));
+        stream.writeFloat(value);
+    });
+}
+
+bool PresetFormat::readState(const void* data, size_t sizeInBytes, ParameterSnapshot& snapshot, int& program) noexcept
+{
+    if (!isState(data, sizeInBytes))
+        return false;
+
+    const auto* bytes = static_cast<const char*>(data);
+
+    if (juce::ByteOrder::littleEndianShort(bytes + 4) > version)
+        return false;
+
+    const auto numValues = (int)juce::ByteOrder::littleEndianShort(bytes + 8);
+    if (sizeInBytes < stateHeaderSize + (size_t)numValues * valueSize)
+        return false;
+
+    program = (int)juce::ByteOrder::littleEndianShort(bytes + 6);
+
+    const auto* values = bytes + stateHeaderSize;
+    overlayValues(snapshot, values, valueSize, numValues,
+                  [values](int i) { return readFloat(values + (size_t)i * valueSize + 4); });
+
+    return true;
+}
+
+//==============================================================================
+PresetBank::PresetBank()
+{
+    open(getDefaultFile());
+}
+
+bool PresetBank::open(const juce::File& file)
+{
+    close();
+
+    if (!file.existsAsFile())
+        return false;
+
+    auto newMapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    const auto* bytes = static_cast<const char*>(newMapping->getData());
+    const auto size = newMapping->getSize();
+
+    if (bytes == nullptr || size < bankHeaderSize
+        || juce::ByteOrder::littleEndianInt(bytes) != PresetFormat::bankMagic
+        || juce::ByteOrder::littleEndianShort(bytes + 4) > PresetFormat::version)
+        return false;
+
+    const auto values = (int)juce::ByteOrder::littleEndianShort(bytes + 6);
+    const auto presets = (int)juce::ByteOrder::littleEndianInt(bytes + 8);
+    const auto newRecordSize = (size_t)PresetFormat::nameLength + (size_t)values * sizeof(float);
+
+    if (presets < 0 || size < bankHeaderSize + (size_t)values * 4 + (size_t)presets * newRecordSize)
+        return false;
+
+    mapping = std::move(newMapping);
+    valueHashes = bytes + bankHeaderSize;
+    records = valueHashes + (size_t)values * 4;
+    numValues = values;
+    numPresets = presets;
+    recordSize = newRecordSize;
+    return true;
+}
+
+void PresetBank::close()
+{
+    mapping.reset();
+    valueHashes = nullptr;
+    records = nullptr;
+    numValues = 0;
+    numPresets = 0;
+    recordSize = 0;
+}
+
+const char* PresetBank::getRecord(int index) const noexcept
+{
+    return juce::isPositiveAndBelow(index, numPresets) ? records + (size_t)index * recordSize : nullptr;
+}
+
+juce::String PresetBank::getName(int index) const
+{
+    const auto* record = getRecord(index);
+    if (record == nullptr)
+        return {};
+
+    //names are zero padded, but a full 32 byte name has no terminator
+    return juce::String::fromUTF8(record, (int)strnlen(record, PresetFormat::nameLength));
+}
+
+bool PresetBank::readPreset(int index, ParameterSnapshot& snapshot) const noexcept
+{
+    const auto* record = getRecord(index);
+    if (record == nullptr)
+        return false;
+
+    const auto* values = record + PresetFormat::nameLength;
+    overlayValues(snapshot, valueHashes, 4, numValues,
+                  [values](int i) { return readFloat(values + (size_t)i * sizeof(float)); });
+
+    return true;
+}
+
+bool PresetBank::write(const juce::File& file, const juce::StringArray& names, const juce::Array<ParameterSnapshot>& presets)
+{
+    jassert(names.size() == presets.size());
+
+    juce::MemoryBlock block;
+    juce::MemoryOutputStream stream(block, false);
+
+    stream.writeInt((int)PresetFormat::bankMagic);
+    stream.writeShort((short)PresetFormat::version);
+    stream.writeShort((short)ParameterSnapshot::numValues);
+    stream.writeInt(presets.size());
+
+    ParameterSnapshot layout;
+    layout.forEachValue([&](const char* parameterID, float&) { stream.writeInt((int)PresetFormat::hashParameterID(parameterID)); });
+
+    for (int i = 0; i < presets.size(); ++i)
+    {
+        char name[PresetFormat::nameLength] = {};
+        names[i].copyToUTF8(name, sizeof(name));
+        stream.write(name, sizeof(name));
+
+        auto values = presets[i];
+        values.forEachValue([&](const char*, float& value) { stream.writeFloat(value); });
+    }
+
+    stream.flush();
+    return file.replaceWithData(block.getData(), block.getSize());
+}
+
+juce::File PresetBank::getDefaultFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("Lapland")
+        .getChildFile("Lapland.lpbank");
+}
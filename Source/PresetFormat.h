@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    PresetFormat.h
+    Created: 18 Oct 2026 9:02:37pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+
+/*Binary plugin state and preset bank files.
+
+  State: "LPST", uint16 version, uint16 program, uint16 value count, uint16 reserved,
+         then per value a uint32 hash of the parameter ID and a float32.
+  Bank:  "LPBK", uint16 version, uint16 value count, uint32 preset count,
+         the uint32 ID hashes once, then per preset a 32 byte name and the float32 values.
+
+  Everything is little endian. Values are matched by ID hash, so unknown IDs are skipped
+  and parameters missing from a file keep whatever value they had.*/
+namespace PresetFormat
+{
+    static constexpr juce::uint32 stateMagic = 0x5453504c; //"LPST"
+    static constexpr juce::uint32 bankMagic = 0x4b42504c; //"LPBK"
+    static constexpr juce::uint16 version = 1;
+    static constexpr int nameLength = 32;
+
+    //FNV-1a, stable across builds and platforms unlike String::hashCode
+    juce::uint32 hashParameterID(const char* parameterID) noexcept;
+
+    bool isState(const void* data, size_t sizeInBytes) noexcept;
+
+    void writeState(juce::MemoryBlock& destination, const ParameterSnapshot& snapshot, int program);
+    //overlays the stored values onto snapshot, returns false for anything that is not a state of a known version
+    bool readState(const void* data, size_t sizeInBytes, ParameterSnapshot& snapshot, int& program) noexcept;
+}
+
+/*Read-only view of a bank file mapped into memory.
+  Opening one only checks the header, presets are read straight out of the mapping,
+  so many plugin instances can share one bank without parsing anything.*/
+class PresetBank
+{
+public:
+    PresetBank();
+
+    bool open(const juce::File& file);
+    void close();
+
+    int getNumPresets() const noexcept { return numPresets; }
+    juce::String getName(int index) const;
+    bool readPreset(int index, ParameterSnapshot& snapshot) const noexcept;
+
+    static bool write(const juce::File& file, const juce::StringArray& names, const juce::Array<ParameterSnapshot>& presets);
+
+    //the bank every plugin instance looks for: <user app data>/Lapland/Lapland.lpbank
+    static juce::File getDefaultFile();
+
+private:
+    const char* getRecord(int index) const noexcept;
+
+    std::unique_ptr<juce::MemoryMappedFile> mapping;
+    const char* valueHashes{ nullptr };
+    const char* records{ nullptr };
+    int numValues{ 0 };
+    int numPresets{ 0 };
+    size_t recordSize{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE(PresetBank)
+};
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    ProgramSwitch.h
+    Created: 18 Oct 2026 9:40:12pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "ParameterSnapshot.h"
+
+/*Hands a complete parameter set from the message thread to the audio thread.
+
+  Setting the parameters one by one could let a block start halfway through a program
+  change and play a mix of two sounds. Instead the message thread publishes the whole set
+  here first, then writes the parameters, then settles. While a switch is unsettled the
+  audio thread renders from the published set, so every block sees either the old program
+  or the new one. The set is guarded by a sequence counter, the audio thread never waits: it
+  makes one attempt per block and keeps the last consistent set for when that attempt fails.*/
+class ProgramSwitch
+{
+public:
+    //message thread
+    void publish(const ParameterSnapshot& snapshot) noexcept
+    {
+        const auto next = sequence.load(std::memory_order_relaxed) + 1;
+        sequence.store(next, std::memory_order_relaxed); //odd while writing
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto copy = snapshot;
+        auto index = 0;
+        copy.forEachValue([&](const char*, float& value) { values[(size_t)index++].store(value, std::memory_order_relaxed); });
+
+        sequence.store(next + 1, std::memory_order_release);
+        pending.store(true, std::memory_order_release);
+    }
+
+    //message thread, once the parameters hold the published values
+    void settle() noexcept { pending.store(false, std::memory_order_release); }
+
+    //audio thread, fills snapshot and returns true while a switch is in flight.
+    //A publisher preempted halfway must not stall the block, so a torn read falls back to the last
+    //consistent set of this switch, or to false (the parameters, not yet written) if there is none
+    bool read(ParameterSnapshot& snapshot) noexcept
+    {
+        if (!pending.load(std::memory_order_acquire))
+        {
+            hasLastRead = false; //a set from an earlier switch is stale once the parameters took over
+            return false;
+        }
+
+        const auto before = sequence.load(std::memory_order_acquire);
+
+        if ((before & 1) == 0)
+        {
+            auto index = 0;
+            snapshot.forEachValue([&](const char*, float& value) { value = values[(size_t)index++].load(std::memory_order_relaxed); });
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before)
+            {
+                lastRead = snapshot;
+                hasLastRead = true;
+                return true;
+            }
+        }
+
+        if (!hasLastRead)
+            return false;
+
+        snapshot = lastRead;
+        return true;
+    }
+
+private:
+    std::array<std::atomic<float>, ParameterSnapshot::numValues> values{};
+    std::atomic<juce::uint32> sequence{ 0 };
+    std::atomic<bool> pending{ false };
+
+    //audio thread only
+    ParameterSnapshot lastRead;
+    bool hasLastRead{ false };
+};
@@ -0,0 +1,122 @@
+/*
+  ==============================================================================
+
+    RenderWorkerPool.cpp
+    Created: 20 Oct 2026 4:37:12pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#include "RenderWorkerPool.h"
+
+RenderWorkerPool::Worker::Worker(RenderWorkerPool& ownerPool, int index)
+    : juce::Thread("Lapland render " + juce::String(index)), pool(ownerPool), threadIndex(index)
+{
+}
+
+void RenderWorkerPool::Worker::wake() noexcept
+{
+    //only an atomic, the audio thread never calls into the OS to hand a job over
+    pendingJobs.fetch_add(1, std::memory_order_release);
+}
+
+void RenderWorkerPool::Worker::run()
+{
+    juce::ScopedNoDenormals noDenormals;
+    auto seenJobs = pendingJobs.load();
+    int sleepMs = 0;
+
+    while (!threadShouldExit())
+    {
+        //jobs come in bursts (several per block), so spin a little before backing off
+        for (int spin = 0; spin < spinCount && pendingJobs.load(std::memory_order_acquire) == seenJobs; ++spin)
+            juce::Thread::yield();
+
+        if (pendingJobs.load(std::memory_order_acquire) == seenJobs)
+        {
+            //poll with a growing sleep, a job that arrives meanwhile is rendered by the calling thread
+            sleepMs = juce::jmin(maxSleepMs, sleepMs + 1);
+            wait(sleepMs);
+            continue;
+        }
+
+        sleepMs = 0;
+        seenJobs = pendingJobs.load(std::memory_order_acquire);
+        pool.renderChunks(threadIndex);
+    }
+}
+
+RenderWorkerPool::~RenderWorkerPool()
+{
+    stop();
+}
+
+void RenderWorkerPool::start(int numWorkers)
+{
+    numWorkers = juce::jlimit(0, maxThreads - 1, numWorkers);
+    if (numWorkers == workers.size()) { return; }
+
+    stop();
+
+    //no affinity, the OS places the helpers next to whatever else the host is running
+    for (int i = 1; i <= numWorkers; ++i)
+    {
+        auto* worker = workers.add(new Worker(*this, i));
+
+        //the audio thread waits for the helpers, so they run at audio priority or the deadline inherits their scheduling
+        if (!worker->startRealtimeThread(juce::Thread::RealtimeOptions{}))
+            worker->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+void RenderWorkerPool::stop()
+{
+    for (auto* worker : workers)
+    {
+        worker->signalThreadShouldExit();
+        worker->notify();
+    }
+
+    for (auto* worker : workers)
+    {
+        worker->stopThread(1000);
+    }
+
+    workers.clear();
+}
+
+void RenderWorkerPool::run(Job& job, int numChunks, int numHelpers) noexcept
+{
+    //publish the job, the release store on claims makes the other fields visible to any claimer
+    currentJob.store(&job, std::memory_order_relaxed);
+    chunksDone.store(0, std::memory_order_relaxed);
+    claims.store((juce::uint64)numChunks << 32, std::memory_order_release);
+
+    numHelpers = juce::jmin(numHelpers, workers.size(), numChunks - 1);
+    for (int i = 0; i < numHelpers; ++i)
+    {
+        workers.getUnchecked(i)->wake();
+    }
+
+    renderChunks(0);
+
+    while (chunksDone.load(std::memory_order_acquire) < numChunks)
+        juce::Thread::yield();
+
+    //a zero chunk count turns late claims away until the next job is published
+    claims.store(0, std::memory_order_relaxed);
+}
+
+void RenderWorkerPool::renderChunks(int threadIndex) noexcept
+{
+    for (;;)
+    {
+        const auto claim = claims.fetch_add(1, std::memory_order_acq_rel);
+        const auto chunk = (int)(claim & 0xffffffff);
+        if (chunk >= (int)(claim >> 32)) { return; }
+
+        currentJob.load(std::memory_order_acquire)->renderChunk(chunk, threadIndex);
+        chunksDone.fetch_add(1, std::memory_order_release);
+    }
+}
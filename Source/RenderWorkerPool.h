@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    RenderWorkerPool.h
+    Created: 20 Oct 2026 4:37:12pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*A few helper threads the audio thread can hand voice rendering to.
+  A job is split into numbered chunks. Every taking part thread, the audio thread included,
+  claims the next chunk with one atomic increment until none are left, so a late or busy helper
+  never holds the block up and nothing is locked while rendering. Handing a job over is one atomic
+  increment per helper, helpers spin for a moment after each job and then poll with a growing sleep.
+  Helpers run at realtime priority, as the audio thread waits on them. They are started and stopped
+  from prepareToPlay or the message thread, never from the audio thread.*/
+class RenderWorkerPool
+{
+public:
+    struct Job
+    {
+        virtual ~Job() = default;
+        //threadIndex is 0 for the calling thread and 1..getNumWorkers() for the helpers
+        virtual void renderChunk(int chunkIndex, int threadIndex) noexcept = 0;
+    };
+
+    static constexpr int maxThreads = 8; //the calling thread included
+
+    ~RenderWorkerPool();
+
+    void start(int numWorkers);
+    void stop();
+    int getNumWorkers() const noexcept { return workers.size(); }
+
+    //renders every chunk on the calling thread and up to numHelpers workers, returns when all are done
+    void run(Job& job, int numChunks, int numHelpers) noexcept;
+
+private:
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(RenderWorkerPool& ownerPool, int index);
+
+        void wake() noexcept;
+        void run() override;
+
+    private:
+        static constexpr int spinCount = 200;
+        static constexpr int maxSleepMs = 4;
+
+        RenderWorkerPool& pool;
+        const int threadIndex;
+        std::atomic<juce::uint32> pendingJobs{ 0 };
+    };
+
+    void renderChunks(int threadIndex) noexcept;
+
+    //chunk count in the high half, next chunk in the low half, so a claim sees both in one operation
+    //and a claim that arrives after its job ended can never be mistaken for a chunk of the next one
+    std::atomic<juce::uint64> claims{ 0 };
+    std::atomic<Job*> currentJob{ nullptr };
+    std::atomic<int> chunksDone{ 0 };
+
+    juce::OwnedArray<Worker> workers;
+};
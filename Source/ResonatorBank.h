@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    ResonatorBank.h
+    Created: 21 Oct 2026 2:47:30pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*Modal filter bank: band-pass resonators at the fundamental and its harmonics, all fed the same
+  input and summed. Partials are laid out in SIMD lanes (4 with SSE/NEON, 8 with AVX), so one
+  register step advances 4 or 8 resonators and 32 partials cost eight register steps a sample.
+
+  Partial h (1 = fundamental) has gain h^-tilt and Q = q * h^-damping, so higher partials get
+  quieter and ring shorter. Partials at or above 0.45 of the sample rate are left out.
+  The gains are normalised so the bank is about as loud as the resonant low-pass modes at the
+  same note and Q. Coefficients are only recomputed when something has changed,
+  on the next process call.*/
+class ResonatorBank
+{
+public:
+    using Register = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int maxPartials = 32;
+    static constexpr int maxChannels = 2;
+
+    void prepare(double newSampleRate) noexcept
+    {
+        sampleRate = newSampleRate;
+        coefficientsAreStale = true;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& channel : states)
+        {
+            std::fill(std::begin(channel.s1), std::end(channel.s1), 0.0f);
+            std::fill(std::begin(channel.s2), std::end(channel.s2), 0.0f);
+        }
+    }
+
+    void setShape(int newNumPartials, float newTilt, float newDamping) noexcept
+    {
+        numPartials = juce::jlimit(1, maxPartials, newNumPartials);
+        tilt = newTilt;
+        damping = newDamping;
+        coefficientsAreStale = true;
+    }
+
+    void setNote(float newFrequency, float newQ) noexcept
+    {
+        frequency = newFrequency;
+        q = newQ;
+        coefficientsAreStale = true;
+    }
+
+    //filters every channel of block in place
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        if (coefficientsAreStale)
+            updateCoefficients();
+
+        const auto numChannels = juce::jmin((int)block.getNumChannels(), maxChannels);
+        const auto numSamples = (int)block.getNumSamples();
+        const auto numRegisters = (activePartials + numLanes - 1) / numLanes;
+
+        if (numRegisters == 0)
+        {
+            block.clear();
+            return;
+        }
+
+        Register b0[maxRegisters], b2[maxRegisters], a1[maxRegisters], a2[maxRegisters], s1[maxRegisters], s2[maxRegisters];
+
+        for (int r = 0; r < numRegisters; ++r)
+        {
+            b0[r] = Register::fromRawArray(coefficients.b0 + r * numLanes);
+            b2[r] = Register::fromRawArray(coefficients.b2 + r * numLanes);
+            a1[r] = Register::fromRawArray(coefficients.a1 + r * numLanes);
+            a2[r] = Register::fromRawArray(coefficients.a2 + r * numLanes);
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto& state = states[(size_t)channel];
+            auto* samples = block.getChannelPointer((size_t)channel);
+
+            for (int r = 0; r < numRegisters; ++r)
+            {
+                s1[r] = Register::fromRawArray(state.s1 + r * numLanes);
+                s2[r] = Register::fromRawArray(state.s2 + r * numLanes);
+            }
+
+            //transposed direct form II, b1 is always 0 for these band-passes
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                const auto x = Register::expand(samples[sample]);
+                auto sum = Register::expand(0.0f);
+
+                for (int r = 0; r < numRegisters; ++r)
+                {
+                    const auto y = b0[r] * x + s1[r];
+                    s1[r] = s2[r] - a1[r] * y;
+                    s2[r] = b2[r] * x - a2[r] * y;
+                    sum += y;
+                }
+
+                samples[sample] = sum.sum();
+            }
+
+            for (int r = 0; r < numRegisters; ++r)
+            {
+                s1[r].copyToRawArray(state.s1 + r * numLanes);
+                s2[r].copyToRawArray(state.s2 + r * numLanes);
+            }
+
+            for (int partial = 0; partial < numRegisters * numLanes; ++partial)
+            {
+                JUCE_SNAP_TO_ZERO(state.s1[partial]);
+                JUCE_SNAP_TO_ZERO(state.s2[partial]);
+            }
+        }
+    }
+
+private:
+    static constexpr int numLanes = (int)Register::SIMDNumElements;
+    static constexpr int maxRegisters = maxPartials / numLanes;
+
+    void updateCoefficients() noexcept
+    {
+        coefficientsAreStale = false;
+
+        const auto nyquistLimit = 0.45 * sampleRate;
+        const auto fundamental = juce::jmax(1.0, (double)frequency);
+
+        //power of each partial with white noise in is about gain^2 * (pi / 2) * bandwidth, sum it for the normalisation
+        auto power = 0.0;
+        activePartials = 0;
+
+        for (int partial = 0; partial < numPartials; ++partial)
+        {
+            const auto harmonic = (double)(partial + 1);
+            const auto partialFrequency = fundamental * harmonic;
+            if (partialFrequency >= nyquistLimit) { break; }
+
+            const auto gain = std::pow(harmonic, (double)-tilt);
+            const auto partialQ = juce::jmax(0.5, (double)q * std::pow(harmonic, (double)-damping));
+            const auto w = juce::MathConstants<double>::twoPi * partialFrequency / sampleRate;
+            const auto alpha = std::sin(w) / (2.0 * partialQ);
+            const auto a0 = 1.0 + alpha;
+
+            coefficients.b0[partial] = (float)(gain * alpha / a0);
+            coefficients.a1[partial] = (float)(-2.0 * std::cos(w) / a0);
+            coefficients.a2[partial] = (float)((1.0 - alpha) / a0);
+
+            power += gain * gain * juce::MathConstants<double>::halfPi * partialFrequency / partialQ;
+            ++activePartials;
+        }
+
+        //a resonant low-pass at the fundamental puts out about (pi / 2) * f * q, match that
+        const auto target = juce::MathConstants<double>::halfPi * fundamental * juce::jmax(1.0, (double)q);
+        const auto normalisation = power > 0.0 ? (float)std::sqrt(target / power) : 0.0f;
+
+        for (int partial = 0; partial < maxPartials; ++partial)
+        {
+            if (partial < activePartials)
+            {
+                coefficients.b0[partial] *= normalisation;
+                coefficients.b2[partial] = -coefficients.b0[partial];
+                continue;
+            }
+
+            //silent lanes in the last register, and no stale ringing when partials come back
+            coefficients.b0[partial] = coefficients.b2[partial] = coefficients.a1[partial] = coefficients.a2[partial] = 0.0f;
+
+            for (auto& channel : states)
+                channel.s1[partial] = channel.s2[partial] = 0.0f;
+        }
+    }
+
+    struct alignas(32) Coefficients
+    {
+        float b0[maxPartials] = {};
+        float b2[maxPartials] = {};
+        float a1[maxPartials] = {};
+        float a2[maxPartials] = {};
+    };
+
+    struct alignas(32) State
+    {
+        float s1[maxPartials] = {};
+        float s2[maxPartials] = {};
+    };
+
+    Coefficients coefficients;
+    std::array<State, maxChannels> states;
+
+    double sampleRate{ 44100.0 };
+    float frequency{ 440.0f };
+    float q{ 20.0f };
+    float tilt{ 1.0f };
+    float damping{ 0.5f };
+    int numPartials{ 16 };
+    int activePartials{ 0 };
+    bool coefficientsAreStale{ true };
+};
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    ScratchArena.h
+    Created: 17 Oct 2026 9:12:40pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*Scratch memory shared by all voices. Sized once in prepareToPlay, after that the
+  voices only borrow views into it, so rendering never touches the allocator.*/
+class ScratchArena
+{
+public:
+    void prepare(int channelsPerSlot, int samplesPerSlot, int slots = 1)
+    {
+        numChannels = juce::jmax(1, channelsPerSlot);
+        maxSamples = juce::jmax(1, samplesPerSlot);
+        numSlots = juce::jmax(1, slots);
+
+        storage.setSize(numChannels * numSlots, maxSamples, false, true, false);
+    }
+
+    juce::dsp::AudioBlock<float> getBlock(int slot, int numSamples) noexcept
+    {
+        jassert(slot < numSlots && numSamples <= maxSamples);
+
+        return juce::dsp::AudioBlock<float>(storage)
+            .getSubsetChannelBlock((size_t)(slot * numChannels), (size_t)numChannels)
+            .getSubBlock(0, (size_t)numSamples);
+    }
+
+    int getNumChannels() const noexcept { return numChannels; }
+    int getMaxSamples() const noexcept { return maxSamples; }
+
+private:
+    juce::AudioBuffer<float> storage;
+
+    int numChannels{ 0 };
+    int maxSamples{ 0 };
+    int numSlots{ 0 };
+};
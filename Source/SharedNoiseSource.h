@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+
+    SharedNoiseSource.h
+    Created: 18 Oct 2026 2:47:53pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "NoiseGenerator.h"
+
+/*One block of white noise per channel, generated once in processBlock and read by every voice,
+  so the noise stage costs the same with one note or twenty-two.
+  In the decorrelated mode there are a few independent streams, and each voice also multiplies
+  its stream by a Walsh-Hadamard sign row. The rows are orthogonal and the noise is white, so two
+  voices sharing a stream are still uncorrelated at every lag, and filtering them does not comb.
+  The sign rows run on a phase that carries over from block to block. Streams times rows covers
+  voicesPerGroup voices, larger voice pools get another set of streams per group so no two voices
+  ever read the same noise.*/
+class SharedNoiseSource
+{
+public:
+    enum class Mode
+    {
+        perVoice = 0,
+        shared,
+        sharedDecorrelated
+    };
+
+    static constexpr int numStreams = 4; //per group
+    static constexpr int signPeriod = 16;
+    static constexpr int voicesPerGroup = numStreams * signPeriod;
+
+    SharedNoiseSource()
+    {
+        for (int row = 0; row < signPeriod; ++row)
+            for (int column = 0; column < signPeriod; ++column)
+                signPatterns[row][column] = juce::countNumberOfBits((juce::uint32)(row & column)) % 2 == 0 ? 1.0f : -1.0f;
+    }
+
+    void prepare(int channels, int maxSamples)
+    {
+        numChannels = juce::jmax(1, channels);
+        streams.setSize(numGroups * numStreams * numChannels, juce::jmax(1, maxSamples), false, true, false);
+        numValidSamples = 0;
+        blockPhase = nextBlockPhase = 0;
+    }
+
+    //not from the audio thread while it runs: voice indices below numVoices must get noise of their own
+    void setNumVoices(int numVoices)
+    {
+        numGroups = juce::jmax(1, (numVoices + voicesPerGroup - 1) / voicesPerGroup);
+        streams.setSize(numGroups * numStreams * numChannels, streams.getNumSamples(), false, true, false);
+        numValidSamples = 0;
+    }
+
+    void setSeed(juce::int64 seed) noexcept { generator.setSeed(seed); }
+    void setMode(Mode newMode) noexcept { mode = newMode; }
+    Mode getMode() const noexcept { return mode; }
+
+    //true when voices should read from here for the current block instead of making their own noise
+    bool isActive() const noexcept { return mode != Mode::perVoice && numValidSamples > 0; }
+
+    //called from processBlock before the voices render, blocks bigger than prepared fall back to per voice noise
+    void generate(int numSamples, float level) noexcept
+    {
+        if (mode == Mode::perVoice || numSamples > streams.getNumSamples())
+        {
+            numValidSamples = 0;
+            return;
+        }
+
+        const auto streamsNeeded = mode == Mode::sharedDecorrelated ? numGroups * numStreams : 1;
+
+        for (int channel = 0; channel < streamsNeeded * numChannels; ++channel)
+        {
+            generator.fill(streams.getWritePointer(channel), numSamples, level);
+        }
+
+        numValidSamples = numSamples;
+        blockPhase = nextBlockPhase;
+        nextBlockPhase = (blockPhase + numSamples) & (signPeriod - 1);
+    }
+
+    //copies this voice's view of the shared noise, startSample is the position in the host block
+    void read(int voiceIndex, int channel, float* dest, int startSample, int numSamples) const noexcept
+    {
+        jassert(startSample + numSamples <= numValidSamples && channel < numChannels);
+
+        if (mode == Mode::shared)
+        {
+            std::copy_n(streams.getReadPointer(channel, startSample), numSamples, dest);
+            return;
+        }
+
+        jassert(voiceIndex < numGroups * voicesPerGroup);
+
+        const auto stream = (voiceIndex / voicesPerGroup) * numStreams + voiceIndex % numStreams;
+        const auto* signs = signPatterns[(voiceIndex / numStreams) % signPeriod];
+        const auto* source = streams.getReadPointer(stream * numChannels + channel, startSample);
+        const auto phase = blockPhase + startSample;
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            dest[sample] = source[sample] * signs[(phase + sample) & (signPeriod - 1)];
+        }
+    }
+
+private:
+    Mode mode{ Mode::perVoice };
+
+    NoiseGenerator generator;
+    juce::AudioBuffer<float> streams;
+    float signPatterns[signPeriod][signPeriod];
+
+    int numChannels{ 1 };
+    int numGroups{ 1 };
+    int numValidSamples{ 0 };
+    int blockPhase{ 0 }; //sign phase at the start of the current block
+    int nextBlockPhase{ 0 };
+};
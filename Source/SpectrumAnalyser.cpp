@@ -0,0 +1,196 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyser.cpp
+    Created: 23 Oct 2026 2:12:51pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalyser.h"
+
+namespace
+{
+    constexpr float minFrequency = 20.0f;
+    constexpr float maxFrequency = 20000.0f;
+    constexpr float fallPerFrame = 1.5f; //dB, so peaks fade instead of flickering
+
+    const juce::Colour backgroundColour(18, 30, 36);
+    const juce::Colour gridColour(0, 115, 105);
+    const juce::Colour spectrumColour(135, 0, 95);
+}
+
+SpectrumAnalyser::SpectrumAnalyser(AnalyserFifo& fifoToRead)
+    : fifo(fifoToRead), incoming((size_t)AnalyserFifo::capacity, 0.0f)
+{
+    setOpaque(true); //the cached background covers everything, so the editor behind is not repainted
+    fifo.setEnabled(true);
+    startTimerHz(refreshRate);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    stopTimer();
+    fifo.setEnabled(false);
+}
+
+void SpectrumAnalyser::paint(juce::Graphics& g)
+{
+    g.drawImageAt(background, 0, 0);
+
+    g.setColour(spectrumColour.withAlpha(0.6f));
+    g.fillPath(spectrumPath);
+    g.setColour(spectrumColour.brighter(0.6f));
+    g.strokePath(spectrumPath, juce::PathStrokeType(1.0f));
+
+    g.setColour(juce::Colours::lightblue.withAlpha(0.8f));
+    g.strokePath(scopePath, juce::PathStrokeType(1.0f));
+}
+
+void SpectrumAnalyser::resized()
+{
+    columnLevels.assign((size_t)juce::jmax(1, getWidth()), minDecibels);
+    renderBackground();
+    spectrumPath.clear();
+    scopePath.clear();
+}
+
+void SpectrumAnalyser::timerCallback()
+{
+    //a hidden editor costs one check per tick, the samples keep until it shows again or the fifo drops them
+    if (!isShowing() || getWidth() <= 0) { return; }
+
+    const auto count = fifo.pop(incoming.data(), (int)incoming.size());
+    if (count == 0) { return; }
+
+    for (int i = juce::jmax(0, count - fftSize); i < count; ++i)
+    {
+        history[(size_t)historyPosition] = incoming[(size_t)i];
+        historyPosition = (historyPosition + 1) % fftSize;
+    }
+
+    updateSpectrum();
+    updateScope();
+    repaint();
+}
+
+void SpectrumAnalyser::renderBackground()
+{
+    const auto width = juce::jmax(1, getWidth());
+    const auto height = juce::jmax(1, getHeight());
+
+    background = juce::Image(juce::Image::RGB, width, height, true);
+    juce::Graphics g(background);
+
+    g.fillAll(backgroundColour);
+    g.setFont(10.0f);
+
+    for (auto frequency : { 50.0f, 100.0f, 200.0f, 500.0f, 1000.0f, 2000.0f, 5000.0f, 10000.0f })
+    {
+        const auto x = frequencyToX(frequency);
+        g.setColour(gridColour.withAlpha(0.35f));
+        g.drawVerticalLine(juce::roundToInt(x), 0.0f, (float)height);
+
+        g.setColour(gridColour);
+        g.drawText(frequency >= 1000.0f ? juce::String(frequency / 1000.0f, 0) + "k" : juce::String(frequency, 0),
+                   juce::roundToInt(x) + 2, height - 12, 30, 12, juce::Justification::left);
+    }
+
+    for (auto decibels = -20.0f; decibels > minDecibels; decibels -= 20.0f)
+    {
+        const auto y = decibelsToY(decibels);
+        g.setColour(gridColour.withAlpha(0.35f));
+        g.drawHorizontalLine(juce::roundToInt(y), 0.0f, (float)width);
+
+        g.setColour(gridColour);
+        g.drawText(juce::String(decibels, 0), 2, juce::roundToInt(y) - 12, 40, 12, juce::Justification::left);
+    }
+}
+
+void SpectrumAnalyser::updateSpectrum()
+{
+    //oldest sample first, then window and transform
+    for (int i = 0; i < fftSize; ++i)
+        fftData[(size_t)i] = history[(size_t)((historyPosition + i) % fftSize)];
+
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    //a full scale sine peaks at fftSize / 4 after the hann window
+    const auto sampleRate = (float)fifo.getSampleRate();
+    const auto normalisation = 4.0f / (float)fftSize;
+    const auto width = (int)columnLevels.size();
+
+    spectrumPath.clear();
+    spectrumPath.startNewSubPath(0.0f, (float)getHeight());
+
+    for (int x = 0; x < width; ++x)
+    {
+        //the bins under this column, the loudest one wins
+        const auto lowFrequency = minFrequency * std::pow(maxFrequency / minFrequency, (float)x / (float)width);
+        const auto highFrequency = minFrequency * std::pow(maxFrequency / minFrequency, (float)(x + 1) / (float)width);
+        const auto lowBin = juce::jlimit(1, fftSize / 2 - 1, (int)(lowFrequency * (float)fftSize / sampleRate));
+        const auto highBin = juce::jlimit(lowBin, fftSize / 2 - 1, (int)(highFrequency * (float)fftSize / sampleRate));
+
+        auto magnitude = 0.0f;
+        for (int bin = lowBin; bin <= highBin; ++bin)
+            magnitude = juce::jmax(magnitude, fftData[(size_t)bin]);
+
+        const auto decibels = juce::Decibels::gainToDecibels(magnitude * normalisation, minDecibels);
+        auto& level = columnLevels[(size_t)x];
+        level = juce::jmax(decibels, level - fallPerFrame);
+
+        spectrumPath.lineTo((float)x, decibelsToY(level));
+    }
+
+    spectrumPath.lineTo((float)width, (float)getHeight());
+    spectrumPath.closeSubPath();
+}
+
+void SpectrumAnalyser::updateScope()
+{
+    //start at the last rising zero crossing that still leaves scopeSize samples, so a steady note stands still
+    const auto newest = historyPosition + fftSize;
+    auto start = newest - scopeSize;
+
+    for (int i = start; i > newest - fftSize + 1; --i)
+    {
+        if (history[(size_t)((i - 1) % fftSize)] < 0.0f && history[(size_t)(i % fftSize)] >= 0.0f)
+        {
+            start = i;
+            break;
+        }
+    }
+
+    //scaled to its own peak, the voices are far below full scale
+    auto peak = 1.0e-3f;
+    for (int i = 0; i < scopeSize; ++i)
+        peak = juce::jmax(peak, std::abs(history[(size_t)((start + i) % fftSize)]));
+
+    const auto height = (float)getHeight();
+    const auto xScale = (float)getWidth() / (float)(scopeSize - 1);
+
+    scopePath.clear();
+
+    for (int i = 0; i < scopeSize; ++i)
+    {
+        const auto value = history[(size_t)((start + i) % fftSize)] / peak;
+        const auto point = juce::Point<float>((float)i * xScale, height * (0.5f - 0.45f * value));
+
+        if (i == 0)
+            scopePath.startNewSubPath(point);
+        else
+            scopePath.lineTo(point);
+    }
+}
+
+float SpectrumAnalyser::frequencyToX(float frequency) const noexcept
+{
+    return (float)getWidth() * std::log(frequency / minFrequency) / std::log(maxFrequency / minFrequency);
+}
+
+float SpectrumAnalyser::decibelsToY(float decibels) const noexcept
+{
+    return (float)getHeight() * juce::jlimit(0.0f, 1.0f, decibels / minDecibels);
+}
@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalyser.h
+    Created: 23 Oct 2026 2:12:51pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "AnalyserFifo.h"
+
+/*Spectrum and scope of the plugin output for the editor.
+  Everything runs on the message thread: a timer at refreshRate drains the AnalyserFifo, runs the
+  FFT and rebuilds two paths, and repaints only this component, and only if new audio arrived.
+  The grid is drawn once into a cached image when the size changes. While the component is not
+  showing the timer does nothing, and the audio thread stops feeding the fifo once it is deleted.*/
+class SpectrumAnalyser : public juce::Component,
+                         private juce::Timer
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int scopeSize = 512;
+    static constexpr int refreshRate = 30;
+    static constexpr float minDecibels = -100.0f;
+
+    explicit SpectrumAnalyser(AnalyserFifo& fifoToRead);
+    ~SpectrumAnalyser() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    void timerCallback() override;
+    void renderBackground();
+    void updateSpectrum();
+    void updateScope();
+
+    float frequencyToX(float frequency) const noexcept;
+    float decibelsToY(float decibels) const noexcept;
+
+    AnalyserFifo& fifo;
+
+    juce::dsp::FFT fft{ fftOrder };
+    juce::dsp::WindowingFunction<float> window{ (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann };
+    std::vector<float> incoming; //one fifo's worth, sized once
+    std::array<float, fftSize> history{}; //newest fftSize samples, circular
+    int historyPosition{ 0 };
+    std::array<float, 2 * fftSize> fftData{};
+    std::vector<float> columnLevels; //dB per pixel column, falls back slowly
+
+    juce::Image background;
+    juce::Path spectrumPath;
+    juce::Path scopePath;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyser)
+};
@@ -0,0 +1,216 @@
+/*
+  ==============================================================================
+
+    StateVariableFilter.h
+    Created: 19 Oct 2026 3:18:24pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "ControlRate.h"
+
+/*Topology preserving (trapezoidal) state variable filter with low, band and high-pass outputs.
+  Cutoff and Q are smoothed at control rate: while they move, the coefficients are recomputed from
+  FastMathApproximations::tan once per control block and ramped linearly across it, so a sweep has
+  no zipper noise and costs one tan per ControlRate::blockSize samples.
+  When both have settled the loop is just the few multiplies of the filter itself.*/
+class StateVariableFilter
+{
+public:
+    enum class Type
+    {
+        lowPass = 0,
+        bandPass,
+        highPass
+    };
+
+    void prepare(double newSampleRate, int numChannels, double smoothingSeconds = 0.02)
+    {
+        sampleRate = newSampleRate;
+        states.resize((size_t)juce::jmax(1, numChannels));
+
+        cutoff.reset(sampleRate / ControlRate::blockSize, smoothingSeconds);
+        resonance.reset(sampleRate / ControlRate::blockSize, smoothingSeconds);
+        samplesToUpdate = 0;
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        for (auto& state : states) { state = {}; }
+    }
+
+    void setType(Type newType) noexcept { type = newType; }
+
+    //snap skips the glide, for a new note rather than a modulation
+    void setCutoff(float frequency, bool snap = false) noexcept
+    {
+        const auto limited = juce::jlimit(10.0f, (float)(sampleRate * 0.49), frequency);
+        snap ? cutoff.setCurrentAndTargetValue(limited) : cutoff.setTargetValue(limited);
+        if (snap) { snapCoefficients(); }
+    }
+
+    void setResonance(float q, bool snap = false) noexcept
+    {
+        const auto limited = juce::jmax(0.1f, q);
+        snap ? resonance.setCurrentAndTargetValue(limited) : resonance.setTargetValue(limited);
+        if (snap) { snapCoefficients(); }
+    }
+
+    //processed in place, sample frames outermost so every channel shares the smoothing
+    void process(const juce::dsp::AudioBlock<float>& block) noexcept
+    {
+        const auto numChannels = (int)block.getNumChannels();
+        const auto numSamples = (int)block.getNumSamples();
+        jassert(numChannels <= (int)states.size());
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            advanceCoefficients();
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* samples = block.getChannelPointer((size_t)channel);
+                samples[sample] = tick(states[(size_t)channel], samples[sample]);
+            }
+        }
+
+        snapStatesToZero();
+    }
+
+    //filters each input, multiplies it by gains and adds it into the matching output, all in one pass.
+    //With panGains one input is filtered once and added to two outputs, scaled by panGains[0] and [1]
+    void processAndAdd(const float* const* inputs, float* const* outputs, int numChannels, const float* gains, int numSamples,
+                       const float* panGains = nullptr) noexcept
+    {
+        jassert(numChannels <= (int)states.size() && (panGains == nullptr || numChannels == 1));
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            advanceCoefficients();
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                const auto out = tick(states[(size_t)channel], inputs[channel][sample]) * gains[sample];
+
+                if (panGains != nullptr)
+                {
+                    outputs[0][sample] += out * panGains[0];
+                    outputs[1][sample] += out * panGains[1];
+                }
+                else
+                {
+                    outputs[channel][sample] += out;
+                }
+            }
+        }
+
+        snapStatesToZero();
+    }
+
+private:
+    struct Coefficients
+    {
+        float k, a1, a2, a3;
+    };
+
+    Coefficients computeCoefficients(float frequency, float q) const noexcept
+    {
+        const auto g = juce::dsp::FastMathApproximations::tan(juce::MathConstants<float>::pi * frequency / (float)sampleRate);
+        const auto newK = 1.0f / q;
+        const auto newA1 = 1.0f / (1.0f + g * (g + newK));
+        return { newK, newA1, g * newA1, g * g * newA1 };
+    }
+
+    //one step of the smoothers, reached at the end of the next control block
+    void rampCoefficients() noexcept
+    {
+        const auto target = computeCoefficients(cutoff.getNextValue(), resonance.getNextValue());
+        k.setTarget(target.k, ControlRate::blockSize);
+        a1.setTarget(target.a1, ControlRate::blockSize);
+        a2.setTarget(target.a2, ControlRate::blockSize);
+        a3.setTarget(target.a3, ControlRate::blockSize);
+        isRamping = true;
+    }
+
+    void snapCoefficients() noexcept
+    {
+        const auto target = computeCoefficients(cutoff.getCurrentValue(), resonance.getCurrentValue());
+        k.snapTo(target.k);
+        a1.snapTo(target.a1);
+        a2.snapTo(target.a2);
+        a3.snapTo(target.a3);
+        isRamping = false;
+    }
+
+    struct State
+    {
+        float ic1eq{ 0.0f };
+        float ic2eq{ 0.0f };
+    };
+
+    //one sample of the coefficient ramps, with a new control step every ControlRate::blockSize samples
+    void advanceCoefficients() noexcept
+    {
+        if (samplesToUpdate == 0)
+        {
+            samplesToUpdate = ControlRate::blockSize;
+
+            if (cutoff.isSmoothing() || resonance.isSmoothing())
+                rampCoefficients();
+            else if (isRamping)
+                snapCoefficients();
+        }
+
+        --samplesToUpdate;
+
+        if (isRamping)
+        {
+            k.next();
+            a1.next();
+            a2.next();
+            a3.next();
+        }
+    }
+
+    float tick(State& state, float input) const noexcept
+    {
+        const auto v3 = input - state.ic2eq;
+        const auto v1 = a1.value * state.ic1eq + a2.value * v3;
+        const auto v2 = state.ic2eq + a2.value * state.ic1eq + a3.value * v3;
+        state.ic1eq = 2.0f * v1 - state.ic1eq;
+        state.ic2eq = 2.0f * v2 - state.ic2eq;
+
+        switch (type)
+        {
+            case Type::lowPass:  return v2;
+            case Type::bandPass: return v1;
+            case Type::highPass: return input - k.value * v1 - v2;
+        }
+
+        return v2;
+    }
+
+    void snapStatesToZero() noexcept
+    {
+        for (auto& state : states)
+        {
+            JUCE_SNAP_TO_ZERO(state.ic1eq);
+            JUCE_SNAP_TO_ZERO(state.ic2eq);
+        }
+    }
+
+    Type type{ Type::lowPass };
+    double sampleRate{ 44100.0 };
+
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> cutoff{ 1000.0f };
+    juce::SmoothedValue<float> resonance{ 0.707f };
+
+    ControlRate::Ramp k, a1, a2, a3;
+    bool isRamping{ false };
+    int samplesToUpdate{ 0 }; //samples left in the current control block
+    std::vector<State> states;
+};
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    StereoDecorrelator.h
+    Created: 22 Oct 2026 4:05:19pm
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*Mix bus widener for the panned mono mode. The mid signal goes through a short chain of
+  Schroeder all-passes, which keeps its spectrum but scrambles its phase, and the result is
+  added to the left channel and subtracted from the right. Only the side signal changes, so
+  the mono sum of the bus is exactly what the voices rendered.*/
+class StereoDecorrelator
+{
+public:
+    static constexpr int numStages = 3;
+    //unrelated delays of a few milliseconds, short enough not to be heard as echoes
+    static constexpr double delaySeconds[numStages] = { 0.0031, 0.0047, 0.0073 };
+    //every trip round a stage loses 6 dB, 20 trips round all of them put the tail below -120 dB
+    static constexpr double tailSeconds = 20.0 * (delaySeconds[0] + delaySeconds[1] + delaySeconds[2]);
+
+    void prepare(double sampleRate)
+    {
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            auto& allPass = stages[(size_t)stage];
+            allPass.buffer.assign((size_t)juce::jmax(1, juce::roundToInt(delaySeconds[stage] * sampleRate)), 0.0f);
+            allPass.position = 0;
+        }
+
+        tailSamples = juce::roundToInt(tailSeconds * sampleRate);
+        tailSamplesLeft = 0;
+
+        //width automation moves the side level, smoothed so steps per block do not zipper
+        amount.reset(sampleRate, 0.05);
+    }
+
+    void reset() noexcept
+    {
+        for (auto& allPass : stages)
+        {
+            std::fill(allPass.buffer.begin(), allPass.buffer.end(), 0.0f);
+            allPass.position = 0;
+        }
+
+        tailSamplesLeft = 0;
+    }
+
+    //true until the all-passes have rung out after the last non-silent input
+    bool isRinging() const noexcept { return tailSamplesLeft > 0; }
+
+    void process(float* left, float* right, int numSamples, float targetAmount) noexcept
+    {
+        amount.setTargetValue(targetAmount);
+
+        for (int sample = 0; sample < numSamples; ++sample)
+        {
+            auto diffused = 0.5f * (left[sample] + right[sample]);
+            tailSamplesLeft = diffused != 0.0f ? tailSamples : juce::jmax(0, tailSamplesLeft - 1);
+
+            for (auto& allPass : stages)
+                diffused = allPass.process(diffused);
+
+            const auto side = amount.getNextValue() * diffused;
+            left[sample] += side;
+            right[sample] -= side;
+        }
+    }
+
+private:
+    static constexpr float feedback = 0.5f;
+
+    struct AllPass
+    {
+        //v[n] = x[n] + g v[n - D], y[n] = v[n - D] - g v[n]
+        float process(float input) noexcept
+        {
+            const auto delayed = buffer[(size_t)position];
+            const auto stored = input + feedback * delayed;
+            buffer[(size_t)position] = stored;
+            position = position + 1 < (int)buffer.size() ? position + 1 : 0;
+            return delayed - feedback * stored;
+        }
+
+        std::vector<float> buffer;
+        int position{ 0 };
+    };
+
+    std::array<AllPass, numStages> stages;
+    juce::SmoothedValue<float> amount{ 0.0f };
+    int tailSamples{ 0 }; //set in prepare
+    int tailSamplesLeft{ 0 };
+};
@@ -18,116 +18,565 @@ bool 	SynthVoice::canPlaySound(juce::SynthesiserSound* sound)
 
 void 	SynthVoice::startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition)
 {
-    juce::MidiMessage msg;
-    updateKeyFreq(msg.getMidiNoteInHertz(midiNoteNumber));
-    adsr.noteOn();
+    //the sources were set from the channel by setChannelExpression, the note starts on them without a glide
+    evaluateModulation(true);
+    updateKeyNote((float)midiNoteNumber);
+    latchOversampling();
+    svf.setCutoff(getModulatedFrequency(), true);
+    svf.setResonance(getModulatedResonance(), true);
+    noteVelocity = velocity;
+    envelopeLevel = 0.0f;
+    noteReleased = false;
+    updatePan(midiNoteNumber);
+    //each note of a render gets its own noise, whichever voice plays it and however many threads render
+    if (noiseIsSeeded) { noise.setSeed(noiseSeed ^ ((juce::int64)midiNoteNumber << 48) ^ ((juce::int64)noteChannel << 40) ^ (juce::int64)noteOnCount); }
+    //an idle voice never steps its smoother, so a new note starts at the current Volume instead of gliding from an old one
+    gain.setCurrentAndTargetValue(gain.getTargetValue());
+    gainRamp.snapTo(gain.getCurrentValue() * noteVelocity * modulationGain);
+    controlSamplesLeft = 0;
+    envelope.noteOn();
     busy = true;
 }
 
 void 	SynthVoice::stopNote(float velocity, bool allowTailOff)
 {
     //updateKeyFreq(20.0);
-    adsr.noteOff();
-    if (!allowTailOff || !adsr.isActive()) { clearCurrentNote(); busy = false;
+    envelope.noteOff();
+    noteReleased = true;
+    if (!allowTailOff || !envelope.isActive()) { envelope.reset(); clearCurrentNote(); busy = false;
     }
-    if (!adsr.isActive()) { busy = false; }
+    if (!envelope.isActive()) { busy = false; }
 }
 
 void    SynthVoice::updateKeyFreq(double midiKeyFreq)
 {
     lastKeyFreq = float(midiKeyFreq);
-    *bpFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(lastSampleRate, lastKeyFreq, lastCleaningLevel);
+    lastKeyNote = FilterCoefficientTable::frequencyToNote(midiKeyFreq);
+    refreshFilterCoefficients();
+}
+
+void    SynthVoice::updateKeyNote(float midiNote)
+{
+    lastKeyNote = midiNote;
+    lastKeyFreq = float(440.0 * std::exp2((midiNote - 69.0) / 12.0));
+    refreshFilterCoefficients();
 }
 
 void    SynthVoice::updateNoiseCleaningLevel(float cleaningLevel)
 {
     lastCleaningLevel = cleaningLevel;
-    *bpFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowPass(lastSampleRate, lastKeyFreq, lastCleaningLevel);
+    refreshFilterCoefficients();
+}
+
+void    SynthVoice::updateFilterMode(int mode)
+{
+    const auto newMode = (FilterMode)mode;
+    if (newMode == filterMode) { return; }
+
+    filterMode = newMode;
+    if (filterMode >= FilterMode::svfLowPass && filterMode <= FilterMode::svfHighPass)
+    {
+        svf.setType((StateVariableFilter::Type)(mode - (int)FilterMode::svfLowPass));
+        oversampledSvf.setType((StateVariableFilter::Type)(mode - (int)FilterMode::svfLowPass));
+    }
+
+    //the two engines keep different state, start the new one from silence (the bank resets its own)
+    svf.reset();
+    oversampledSvf.reset();
+    resonators.reset();
+    for (auto& state : oversampledBiquads) { state = {}; }
+    for (auto& state : referenceBiquads) { state = {}; }
+}
+
+void    SynthVoice::updateOversampling(int factor)
+{
+    oversampling = factor >= 4 ? 4 : (factor >= 2 ? 2 : 1);
+}
+
+void    SynthVoice::updateStereo(bool renderMonoAndPan, float width)
+{
+    //the bank starts from silence on a mode switch, so does its reference
+    if (renderMonoAndPan != pannedMono)
+    {
+        for (auto& state : referenceBiquads) { state = {}; }
+    }
 
+    pannedMono = renderMonoAndPan;
+    stereoWidth = width;
+}
+
+void    SynthVoice::updateNoiseSeed(juce::int64 instanceSeed)
+{
+    noiseSeed = instanceSeed;
+    noiseIsSeeded = true;
+}
+
+void    SynthVoice::updateVoiceBank(bool useBank)
+{
+    voiceBankEnabled = useBank;
+}
+
+void    SynthVoice::updatePan(int midiNoteNumber)
+{
+    //low notes to the left, high notes to the right, spread by the width
+    const auto position = stereoWidth * juce::jlimit(-1.0f, 1.0f, (float)(midiNoteNumber - 60) / 48.0f);
+    const auto angle = (position + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+
+    //constant power, scaled so the two channels carry the same power as two independent ones
+    panLeft = juce::MathConstants<float>::sqrt2 * std::cos(angle);
+    panRight = juce::MathConstants<float>::sqrt2 * std::sin(angle);
+}
+
+void    SynthVoice::updateSilenceFloor(float decibels)
+{
+    silenceFloor = juce::Decibels::decibelsToGain(decibels);
+}
+
+void    SynthVoice::updatePartials(int numPartials, float tilt, float damping)
+{
+    resonators.setShape(numPartials, tilt, damping);
+}
+
+void    SynthVoice::latchOversampling()
+{
+    //only notes with a cutoff high enough to warp at the host rate pay for the extra samples,
+    //the resonators simply leave out partials near Nyquist instead
+    const auto factor = filterMode != FilterMode::resonatorBank && lastKeyFreq > oversamplingThreshold * lastSampleRate ? oversampling : 1;
+
+    if (factor != noteOversampling)
+    {
+        for (auto& decimator : decimators) { decimator.reset(); }
+        for (auto& state : oversampledBiquads) { state = {}; }
+        oversampledSvf.reset();
+    }
+
+    noteOversampling = factor;
+
+    if (noteOversampling > 1)
+    {
+        //prepare only resets the smoothers here, the channel count has not changed since prepareToPlay
+        if (oversampledSvfFactor != noteOversampling)
+        {
+            oversampledSvf.prepare(lastSampleRate * noteOversampling, numOutputChannels);
+            oversampledSvfFactor = noteOversampling;
+        }
+
+        oversampledSvf.setResonance(getModulatedResonance(), true);
+        oversampledSvf.setCutoff(getModulatedFrequency(), true);
+        refreshFilterCoefficients();
+    }
+}
+
+void    SynthVoice::refreshFilterCoefficients()
+{
+    const auto note = getModulatedNote();
+    const auto frequency = getModulatedFrequency();
+    const auto resonance = getModulatedResonance();
+    appliedNoteOffset = noteOffset.getCurrentValue();
+    appliedResonanceOffset = resonanceOffset.getCurrentValue();
+
+    //table lookup only, no trig and no allocation, safe from the audio thread
+    if (filterTable != nullptr)
+        filterCoefficients = filterTable->getCoefficients(note, resonance);
+
+    //the state variable filter glides to the new values itself
+    svf.setCutoff(frequency);
+    svf.setResonance(resonance);
+
+    //only marks the partials stale, they are recomputed when a resonator voice next renders
+    resonators.setNote(frequency, resonance);
+
+    if (noteOversampling > 1)
+    {
+        if (oversampledTables != nullptr)
+            oversampledCoefficients = oversampledTables[noteOversampling == 4 ? 1 : 0].getCoefficients(note, resonance);
+
+        oversampledSvf.setCutoff(frequency);
+        oversampledSvf.setResonance(resonance);
+    }
 }
 
 void    SynthVoice::updateADSR(float a, float d, float s, float r)
 {
-    adsrParameters.attack = a;
-    adsrParameters.decay = d;
-    adsrParameters.sustain = s;
-    adsrParameters.release = r;
+    envelopeParameters.attack = a;
+    envelopeParameters.decay = d;
+    envelopeParameters.sustain = s;
+    envelopeParameters.release = r;
 
-    adsr.setParameters(adsrParameters);
+    envelope.setParameters(envelopeParameters);
 
 }
 
 void SynthVoice::updateVolume(float volume)
 {
-    gain.setGainLinear(volume);
+    gain.setTargetValue(volume);
+}
+
+void    SynthVoice::updateModulation(const ModulationMatrix& matrix)
+{
+    modulationMatrix = matrix;
+    modulationPending = true;
+    modulationIsMoving = true;
+}
+
+void 	SynthVoice::pitchWheelMoved(int newPitchWheelValue)
+{
+    setModulationSource(ModulationMatrix::pitchBend, juce::jlimit(-1.0f, 1.0f, (float)(newPitchWheelValue - 8192) / 8191.0f));
+}
+
+void 	SynthVoice::controllerMoved(int controllerNumber, int newControllerValue)
+{
+    const auto source = modulationMatrix.sourceForController(controllerNumber);
+    if (source != ModulationMatrix::off) { setModulationSource(source, (float)newControllerValue / 127.0f); }
+}
+
+void 	SynthVoice::channelPressureChanged(int newChannelPressureValue)
+{
+    setModulationSource(ModulationMatrix::pressure, (float)newChannelPressureValue / 127.0f);
+}
+
+void 	SynthVoice::aftertouchChanged(int newAftertouchValue)
+{
+    setModulationSource(ModulationMatrix::pressure, (float)newAftertouchValue / 127.0f);
+}
+
+void    SynthVoice::setChannelExpression(int pitchWheelValue, float pressure, const float* controllers) noexcept
+{
+    modulationSources[ModulationMatrix::pitchBend] = juce::jlimit(-1.0f, 1.0f, (float)(pitchWheelValue - 8192) / 8191.0f);
+    modulationSources[ModulationMatrix::pressure] = pressure;
+    modulationSources[ModulationMatrix::slide] = controllers[ModulationMatrix::slideController];
+    modulationSources[ModulationMatrix::modWheel] = controllers[ModulationMatrix::modWheelController];
+    modulationSources[ModulationMatrix::controller] = controllers[juce::jlimit(0, 127, modulationMatrix.assignableController)];
 }
 
-void 	SynthVoice::pitchWheelMoved(int newPitchWheelValue) {}
-void 	SynthVoice::controllerMoved(int controllerNumber, int newControllerValue) {}
+void    SynthVoice::setModulationSource(int source, float value) noexcept
+{
+    //a dense MPE stream only lands here, the matrix and the coefficients wait for the next control step
+    if (modulationSources[(size_t)source] == value) { return; }
+
+    modulationSources[(size_t)source] = value;
+    modulationPending = true;
 
+    if (!modulationIsMoving)
+    {
+        modulationIsMoving = true;
+        modulationSamplesLeft = 0;
+    }
+}
 
-void    SynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels)
+void    SynthVoice::evaluateModulation(bool snap) noexcept
 {
-    juce::dsp::ProcessSpec spec;
+    const auto targets = modulationMatrix.evaluate(modulationSources);
+    const auto setTarget = [snap](juce::SmoothedValue<float>& value, float target)
+    {
+        snap ? value.setCurrentAndTargetValue(target) : value.setTargetValue(target);
+    };
+
+    setTarget(noteOffset, modulationSources[ModulationMatrix::pitchBend] * modulationMatrix.bendRange
+                          + targets[ModulationMatrix::cutoff] * ModulationMatrix::cutoffRange);
+    setTarget(resonanceOffset, targets[ModulationMatrix::resonance] * ModulationMatrix::resonanceRange);
+    setTarget(gainOffset, targets[ModulationMatrix::gain] * ModulationMatrix::gainRange);
+    setTarget(envelopeTimeOffset, targets[ModulationMatrix::envelopeTime] * ModulationMatrix::envelopeTimeRange);
+
+    modulationPending = false;
+
+    if (snap)
+    {
+        modulationIsMoving = false;
+        applyModulation();
+    }
+}
+
+void    SynthVoice::renderModulation(int numSamples) noexcept
+{
+    if (!modulationIsMoving) { return; }
+
+    //one step per control block starting in the next numSamples
+    const auto steps = numSamples > modulationSamplesLeft ? (numSamples - modulationSamplesLeft + ControlRate::blockSize - 1) / ControlRate::blockSize : 0;
+    modulationSamplesLeft += steps * ControlRate::blockSize - numSamples;
+    if (steps == 0) { return; }
+
+    if (modulationPending) { evaluateModulation(false); }
+
+    noteOffset.skip(steps);
+    resonanceOffset.skip(steps);
+    gainOffset.skip(steps);
+    envelopeTimeOffset.skip(steps);
+
+    applyModulation();
+
+    modulationIsMoving = modulationPending || noteOffset.isSmoothing() || resonanceOffset.isSmoothing()
+                         || gainOffset.isSmoothing() || envelopeTimeOffset.isSmoothing();
+}
+
+void    SynthVoice::applyModulation() noexcept
+{
+    modulationGain = juce::Decibels::decibelsToGain(gainOffset.getCurrentValue());
+    envelope.setTimeScale(std::exp2(envelopeTimeOffset.getCurrentValue()));
+
+    //table lookups and smoother targets, no allocation, and only when the filter actually moved
+    if (noteOffset.getCurrentValue() != appliedNoteOffset || resonanceOffset.getCurrentValue() != appliedResonanceOffset)
+        refreshFilterCoefficients();
+}
+
+float   SynthVoice::getModulatedFrequency() const noexcept
+{
+    if (noteOffset.getCurrentValue() == 0.0f) { return lastKeyFreq; }
+    return float(440.0 * std::exp2((getModulatedNote() - 69.0) / 12.0));
+}
+
+float   SynthVoice::getModulatedResonance() const noexcept
+{
+    if (resonanceOffset.getCurrentValue() == 0.0f) { return lastCleaningLevel; }
+    return lastCleaningLevel * std::exp2(resonanceOffset.getCurrentValue());
+}
+
+
+void    SynthVoice::prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels, ScratchArena& scratchArena, const SharedNoiseSource& noiseSource,
+                                  const FilterCoefficientTable& coefficientTable, const FilterCoefficientTable* oversampledCoefficientTables)
+{
+    scratch = &scratchArena;
+    sharedNoise = &noiseSource;
+    filterTable = &coefficientTable;
+    oversampledTables = oversampledCoefficientTables;
+
     lastSampleRate = sampleRate;
-    spec.sampleRate = sampleRate;
-    spec.maximumBlockSize = samplesPerBlock;
-    spec.numChannels = outputChannels;
+    numOutputChannels = outputChannels;
+
+    svf.prepare(sampleRate, outputChannels);
+    svf.setResonance(lastCleaningLevel, true);
+    resonators.prepare(sampleRate);
 
-    bpFilter.prepare(spec);
-    gain.prepare(spec);
+    noteOversampling = 1;
+    oversampledBiquads.assign((size_t)juce::jmax(1, outputChannels), {});
+    referenceBiquads.assign((size_t)juce::jmax(1, outputChannels), {});
+    oversampledSvf.prepare(sampleRate * 2.0, outputChannels);
+    oversampledSvfFactor = 2;
+    //the first 4x stage only has to keep 1.5..2 times the host rate out of the audio band, the last one is the steep one
+    decimators[0].prepare(outputChannels, 4, 7.0f);
+    decimators[1].prepare(outputChannels, HalfBandDecimator::maxPairs, 7.0f);
+    envelope.setSampleRate(sampleRate);
+    envelope.setParameters(envelopeParameters);
+    envelope.reset();
+    //the gain steps once per control block, so it runs at that rate
+    gainRamp.snapTo(0.0f);
+    controlSamplesLeft = 0;
+    gain.reset(sampleRate / ControlRate::blockSize, 0.05); //50 ms, so Volume moves under a sounding note do not click
+    for (auto* offset : { &noteOffset, &resonanceOffset, &gainOffset, &envelopeTimeOffset })
+        offset->reset(sampleRate / ControlRate::blockSize, 0.01);
+    modulationSamplesLeft = 0;
     //gain.setGainLinear(0.01f);
-    bpFilter.reset();
     updateKeyFreq(20.0);
 }
 
-void 	SynthVoice::renderNextBlock(juce::AudioBuffer< float >& outputBuffer, int startSample, int numSamples)
+void    SynthVoice::renderNoise(float* dest, int channel, int startSample, int numSamples) noexcept
 {
-    if (!isVoiceActive()) { return; }
-
-    laplandBuffer.setSize(outputBuffer.getNumChannels(), numSamples, false, false, true);
+    if (sharedNoise != nullptr && sharedNoise->isActive())
+        sharedNoise->read(voiceIndex, channel, dest, startSample, numSamples);
+    else
+        noise.fill(dest, numSamples, noiseLevel);
+}
 
-    laplandBuffer.clear();
+void    SynthVoice::renderEnvelope(float* dest, int numSamples) noexcept
+{
+    envelope.render(dest, numSamples);
 
-    for (int channel = 0; channel < laplandBuffer.getNumChannels(); ++channel)
+    //one gain step per control block, a straight line in between, usually flat
+    for (int done = 0; done < numSamples;)
     {
-        float* buffer_ = laplandBuffer.getWritePointer(channel);
-        for (int sample = 0; sample < laplandBuffer.getNumSamples(); ++sample)
+        if (controlSamplesLeft == 0)
+        {
+            gainRamp.setTarget(gain.getNextValue() * noteVelocity * modulationGain, ControlRate::blockSize);
+            controlSamplesLeft = ControlRate::blockSize;
+        }
+
+        const auto run = juce::jmin(controlSamplesLeft, numSamples - done);
+
+        if (gainRamp.isRamping())
+        {
+            float gains[ControlRate::blockSize];
+            gainRamp.fill(gains, run);
+            juce::FloatVectorOperations::multiply(dest + done, gains, run);
+        }
+        else
         {
-            buffer_[sample] = (random.nextFloat() * 2.0f - 1.0f) * 0.01f;
+            juce::FloatVectorOperations::multiply(dest + done, gainRamp.value, run);
         }
+
+        controlSamplesLeft -= run;
+        done += run;
     }
 
-    juce::dsp::AudioBlock<float> block(laplandBuffer);
+    if (numSamples > 0) { envelopeLevel = dest[numSamples - 1]; }
+}
+
+void    SynthVoice::finishBlock()
+{
+    //the envelope is applied after the filter, so below the floor nothing audible is left of the tail
+    if (noteReleased && envelope.isActive() && envelopeLevel < silenceFloor) { envelope.reset(); }
 
-    /*
-    code from pluginprocessor
+    if (!envelope.isActive()) { clearCurrentNote(); busy = false; }
+}
 
-        for (const auto& meta : midiMessages)
-    {
-        const auto msg = meta.getMessage();
+void 	SynthVoice::renderNextBlock(juce::AudioBuffer< float >& outputBuffer, int startSample, int numSamples)
+{
+    //the low-pass mode is rendered by the VoiceBank, unless it is bypassed for verification
+    if (!isVoiceActive() || usesVoiceBank()) { return; }
 
-        const auto timestamp = meta.samplePosition;
+    jassert(scratch != nullptr);
 
-        auto mtof = msg.getMidiNoteInHertz(msg.getNoteNumber());
+    const auto numChannels = juce::jmin(outputBuffer.getNumChannels(), scratch->getNumChannels() - 1);
+    const auto factor = noteOversampling;
+    const auto panned = pannedMono && numChannels == 2;
+    const auto renderedChannels = panned ? 1 : numChannels;
 
-        for (int i = 0; i < lapland.getNumVoices(); ++i)
+    if (factor == 1 && filterMode != FilterMode::resonatorBank && numChannels <= maxFusedChannels)
+    {
+        renderFused(outputBuffer, startSample, numSamples, numChannels, panned);
+        finishBlock();
+        return;
+    }
+
+    //hosts may hand us more than they promised in prepareToPlay, so work in arena sized chunks
+    while (numSamples > 0)
+    {
+        const auto blockSize = juce::jmin(numSamples, scratch->getMaxSamples() / factor);
+        renderModulation(blockSize);
+        auto slot = scratch->getBlock(scratchSlot, blockSize * factor);
+        auto block = slot.getSubsetChannelBlock(0, (size_t)renderedChannels);
+        auto* envelope = slot.getChannelPointer((size_t)numChannels);
+
+        if (factor > 1)
         {
-            if (auto voice = dynamic_cast<SynthVoice*>(lapland.getVoice(i)))
+            renderOversampled(block, renderedChannels, blockSize);
+        }
+        else
+        {
+            for (int channel = 0; channel < renderedChannels; ++channel)
             {
-                voice->updateKeyFreq(mtof);
+                renderNoise(block.getChannelPointer((size_t)channel), channel, startSample, blockSize);
             }
+
+            if (filterMode == FilterMode::resonatorBank)
+                resonators.process(block);
+            else
+                svf.process(block);
+        }
+
+        renderEnvelope(envelope, blockSize);
+
+        for (int channel = 0; channel < renderedChannels; ++channel)
+        {
+            juce::FloatVectorOperations::multiply(block.getChannelPointer((size_t)channel), envelope, blockSize);
+        }
+
+        if (panned)
+        {
+            outputBuffer.addFrom(0, startSample, block.getChannelPointer(0), blockSize, panLeft);
+            outputBuffer.addFrom(1, startSample, block.getChannelPointer(0), blockSize, panRight);
+        }
+        else
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                outputBuffer.addFrom(channel, startSample, block.getChannelPointer((size_t)channel), blockSize);
         }
+
+        startSample += blockSize;
+        numSamples -= blockSize;
+    }
+
+    finishBlock();
+}
+
+void    SynthVoice::renderFused(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples, int numChannels, bool panned) noexcept
+{
+    //noise, filter, envelope and the add into the output in one pass per tile, gain and velocity are
+    //already folded into the envelope, so nothing goes through the scratch arena
+    float noiseTile[maxFusedChannels][fusedTileSize];
+    float envelopeTile[fusedTileSize];
+    const float* inputs[maxFusedChannels];
+    float* outputs[maxFusedChannels];
+    const float panGains[] = { panLeft, panRight };
+    const auto renderedChannels = panned ? 1 : numChannels;
+
+    for (int done = 0; done < numSamples; done += fusedTileSize)
+    {
+        const auto run = juce::jmin(fusedTileSize, numSamples - done);
+        renderModulation(run);
+
+        for (int channel = 0; channel < renderedChannels; ++channel)
+        {
+            renderNoise(noiseTile[channel], channel, startSample + done, run);
+            inputs[channel] = noiseTile[channel];
+        }
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            outputs[channel] = outputBuffer.getWritePointer(channel, startSample + done);
+
+        renderEnvelope(envelopeTile, run);
+
+        if (filterMode == FilterMode::biquadLowPass)
+            addBiquadTile(noiseTile, outputs, renderedChannels, envelopeTile, run, panned);
+        else
+            svf.processAndAdd(inputs, outputs, renderedChannels, envelopeTile, run, panned ? panGains : nullptr);
+    }
+}
+
+void    SynthVoice::addBiquadTile(float (*tile)[fusedTileSize], float* const* outputs, int renderedChannels, const float* envelopeTile, int numSamples, bool panned) noexcept
+{
+    //the VoiceBank lane arithmetic for one voice: same tiles, same recursion, filter then envelope then pan
+    for (int channel = 0; channel < renderedChannels; ++channel)
+    {
+        referenceBiquads[(size_t)channel].process(filterCoefficients, tile[channel], numSamples);
+        juce::FloatVectorOperations::multiply(tile[channel], envelopeTile, numSamples);
+    }
+
+    if (panned)
+    {
+        juce::FloatVectorOperations::addWithMultiply(outputs[0], tile[0], panLeft, numSamples);
+        juce::FloatVectorOperations::addWithMultiply(outputs[1], tile[0], panRight, numSamples);
+    }
+    else
+    {
+        for (int channel = 0; channel < renderedChannels; ++channel)
+            juce::FloatVectorOperations::add(outputs[channel], tile[channel], numSamples);
     }
-    */
-    gain.process(juce::dsp::ProcessContextReplacing<float>(block));
-    bpFilter.process(juce::dsp::ProcessContextReplacing<float>(block));
-    adsr.applyEnvelopeToBuffer(laplandBuffer, 0, laplandBuffer.getNumSamples());
-    
+}
+
+void    SynthVoice::renderOversampled(juce::dsp::AudioBlock<float>& block, int numChannels, int numSamples) noexcept
+{
+    //noise straight at the high rate, so nothing has to be interpolated up. Its power spreads over
+    //factor times the bandwidth, the level keeps the density inside the audio band as at the host rate
+    const auto numWideSamples = numSamples * noteOversampling;
+    const auto level = noiseLevel * std::sqrt((float)noteOversampling);
 
-    for (int channel = 0; channel < outputBuffer.getNumChannels(); ++channel)
+    for (int channel = 0; channel < numChannels; ++channel)
     {
-        outputBuffer.addFrom(channel, startSample, laplandBuffer, channel, 0, numSamples);
-        if (!adsr.isActive()) { clearCurrentNote(); busy = false; }
+        noise.fill(block.getChannelPointer((size_t)channel), numWideSamples, level);
     }
-}
\ No newline at end of file
+
+    if (filterMode == FilterMode::biquadLowPass)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            oversampledBiquads[(size_t)channel].process(oversampledCoefficients, block.getChannelPointer((size_t)channel), numWideSamples);
+    }
+    else
+    {
+        oversampledSvf.process(block);
+    }
+
+    //back to the host rate, the result ends up in the first numSamples of every row
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* samples = block.getChannelPointer((size_t)channel);
+        auto length = numWideSamples;
+
+        if (noteOversampling == 4)
+        {
+            decimators[0].process(samples, channel, length);
+            length /= 2;
+        }
+
+        decimators[1].process(samples, channel, length);
+    }
+}
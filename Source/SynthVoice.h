@@ -11,35 +11,167 @@
 #pragma once
 #include <JuceHeader.h>
 #include "SynthSound.h"
+#include "ScratchArena.h"
+#include "NoiseGenerator.h"
+#include "SharedNoiseSource.h"
+#include "Biquad.h"
+#include "FilterCoefficientTable.h"
+#include "StateVariableFilter.h"
+#include "HalfBandDecimator.h"
+#include "ResonatorBank.h"
+#include "ControlRate.h"
+#include "EnvelopeGenerator.h"
+#include "ModulationMatrix.h"
 
 class SynthVoice : public juce::SynthesiserVoice
 {
 public:
+    enum class FilterMode
+    {
+        biquadLowPass = 0,  //table driven, cheapest for static settings
+        svfLowPass,         //state variable engine, glides between settings per sample
+        svfBandPass,
+        svfHighPass,
+        resonatorBank       //band-pass partials at the note's harmonics, clearly pitched
+    };
+
+    static constexpr float noiseLevel = 0.01f; //white noise amplitude before gain and filtering
+    static constexpr float oversamplingThreshold = 0.2f; //notes with a cutoff above this fraction of the host rate get oversampled
+    static constexpr int maxOversampling = 4;
+
+    explicit        SynthVoice(int index) : voiceIndex(index) {}
     virtual bool 	canPlaySound(juce::SynthesiserSound* sound) override;
     virtual void 	startNote(int midiNoteNumber, float velocity, juce::SynthesiserSound* sound, int currentPitchWheelPosition) override;
     virtual void 	stopNote(float velocity, bool allowTailOff) override;
     void            updateKeyFreq(double midiKeyFreq);
+    void            updateKeyNote(float midiNote);
     void            updateNoiseCleaningLevel(float cleaningLevel);
+    void            updateFilterMode(int mode);
     void            updateADSR(float a, float d, float s, float r);
     void            updateVolume(float volume);
+    void            updateOversampling(int factor); //1, 2 or 4, picked up by the next note
+    void            updatePartials(int numPartials, float tilt, float damping);
+    void            updateSilenceFloor(float decibels);
+    void            updateStereo(bool renderMonoAndPan, float width); //the pan is picked up by the next note
+    void            updateNoiseSeed(juce::int64 instanceSeed); //every note then reseeds its noise from this and its note origin
+    void            updateModulation(const ModulationMatrix& matrix);
+    void            updateVoiceBank(bool useBank); //false renders the low-pass here, one voice at a time, as a reference for the bank
     virtual void 	pitchWheelMoved(int newPitchWheelValue) override;
     virtual void 	controllerMoved(int controllerNumber, int newControllerValue) override;
-    void            prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels);
+    virtual void 	channelPressureChanged(int newChannelPressureValue) override;
+    virtual void 	aftertouchChanged(int newAftertouchValue) override;
+    //the channel's last values before startNote, controllers holds 128 values in 0..1
+    void            setChannelExpression(int pitchWheelValue, float pressure, const float* controllers) noexcept;
+    //also before startNote: the channel and how many notes the instance started since prepareToPlay, both go into the noise seed
+    void            setNoteOrigin(int midiChannel, juce::uint32 noteOnIndex) noexcept { noteChannel = midiChannel; noteOnCount = noteOnIndex; }
+    void            prepareToPlay(double sampleRate, int samplesPerBlock, int outputChannels, ScratchArena& scratchArena, const SharedNoiseSource& noiseSource,
+                                  const FilterCoefficientTable& coefficientTable, const FilterCoefficientTable* oversampledTables);
     virtual void 	renderNextBlock(juce::AudioBuffer< float >& outputBuffer, int startSample, int numSamples) override;
-    bool            isBusy(){ return &busy; }
+    bool            isBusy() const noexcept { return busy; }
+
+    //the biquad low-pass voices are rendered together by the VoiceBank, these are its hooks
+    bool            usesVoiceBank() const noexcept { return voiceBankEnabled && filterMode == FilterMode::biquadLowPass && noteOversampling == 1; }
+    int             getVoiceIndex() const noexcept { return voiceIndex; }
+    const BiquadCoefficients& getFilterCoefficients() const noexcept { return filterCoefficients; }
+    void            renderNoise(float* dest, int channel, int startSample, int numSamples) noexcept;
+    void            renderEnvelope(float* dest, int numSamples) noexcept;
+    void            renderModulation(int numSamples) noexcept; //call before the filter coefficients are used for the next numSamples
+    void            finishBlock();
+    void            setScratchSlot(int slot) noexcept { scratchSlot = slot; } //one arena slot per render thread
+
+    float           getEnvelopeLevel() const noexcept { return envelopeLevel; } //last rendered envelope sample, gain and velocity included
+    float           getNoteVelocity() const noexcept { return noteVelocity; }
+    float           getPanLeft() const noexcept { return panLeft; }
+    float           getPanRight() const noexcept { return panRight; }
 private:
-    juce::dsp::ProcessorDuplicator <juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients <float>> bpFilter;
+    void            refreshFilterCoefficients();
+    void            setModulationSource(int source, float value) noexcept;
+    void            evaluateModulation(bool snap) noexcept;
+    void            applyModulation() noexcept;
+    float           getModulatedNote() const noexcept { return lastKeyNote + noteOffset.getCurrentValue(); }
+    float           getModulatedFrequency() const noexcept;
+    float           getModulatedResonance() const noexcept;
+    void            latchOversampling();
+    void            updatePan(int midiNoteNumber);
+    void            renderOversampled(juce::dsp::AudioBlock<float>& block, int numChannels, int numSamples) noexcept;
+    void            renderFused(juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples, int numChannels, bool panned) noexcept;
+
+    static constexpr int fusedTileSize = 64; //noise and envelope tile of the fused path, stays in L1. The VoiceBank tile, so the reference low-pass steps like it
+    static constexpr int maxFusedChannels = 2;
+
+    void            addBiquadTile(float (*tile)[fusedTileSize], float* const* outputs, int renderedChannels, const float* envelopeTile, int numSamples, bool panned) noexcept;
+
 
-    float lastSampleRate; //set in preparetoplay
-    float lastKeyFreq; //set in updateKeyFreq
-    float lastCleaningLevel; //set in updateNoiseCleaning
+    BiquadCoefficients filterCoefficients; //the state lives in the VoiceBank
+    std::vector<BiquadState> referenceBiquads; //one per channel, only used while the VoiceBank is bypassed
+    bool voiceBankEnabled{ true };
+    StateVariableFilter svf;
+    FilterMode filterMode{ FilterMode::biquadLowPass };
+    const FilterCoefficientTable* filterTable{ nullptr }; //owned by the processor, rebuilt in prepareToPlay
 
-    juce::Random random;
+    //oversampled path, only used by notes whose cutoff is above the threshold
+    int oversampling{ 1 }; //set by the Oversampling parameter
+    int noteOversampling{ 1 }; //latched in startNote, so a sounding note never changes rate
+    const FilterCoefficientTable* oversampledTables{ nullptr }; //two tables, at 2x and 4x the host rate
+    BiquadCoefficients oversampledCoefficients;
+    std::vector<BiquadState> oversampledBiquads; //one per channel
+    StateVariableFilter oversampledSvf;
+    int oversampledSvfFactor{ 0 }; //rate the oversampled svf was last prepared for
+    HalfBandDecimator decimators[2]; //4x to 2x (short), 2x to 1x (steep)
 
-    juce::ADSR adsr;
-    juce::ADSR::Parameters adsrParameters;
-    juce::dsp::Gain <float> gain;
+    ResonatorBank resonators; //resonator mode, tuned to the note in refreshFilterCoefficients
+
+    float lastSampleRate{ 44100.0f }; //set in preparetoplay
+    int numOutputChannels{ 2 }; //set in preparetoplay
+    float lastKeyFreq{ 20.0f }; //set in updateKeyFreq
+    float lastKeyNote{ 15.5f }; //same as lastKeyFreq, in (fractional) MIDI notes
+    float lastCleaningLevel{ 1000.0f }; //set in updateNoiseCleaning
+
+    NoiseGenerator noise;
+    juce::int64 noiseSeed{ 0 }; //instance seed for reproducible renders
+    bool noiseIsSeeded{ false }; //false seeds from the system once, notes then continue the stream
+    int noteChannel{ 1 }; //set in setNoteOrigin
+    juce::uint32 noteOnCount{ 0 }; //set in setNoteOrigin
+    const SharedNoiseSource* sharedNoise{ nullptr }; //read only, filled once per block by the processor
+    int voiceIndex; //picks the shared noise stream and sign pattern
+
+    EnvelopeGenerator envelope; //exact to the sample, stage boundaries included
+    EnvelopeGenerator::Parameters envelopeParameters;
+    ControlRate::Ramp gainRamp; //straight line between two control steps of gain * velocity
+    int controlSamplesLeft{ 0 }; //samples until the next gain step, 0 steps at the next rendered sample
+    float noteVelocity{ 1.0f }; //set in startNote, scales the envelope
+    float envelopeLevel{ 0.0f }; //set in renderEnvelope, used for voice stealing
+    float silenceFloor{ 1.0e-6f }; //a released note ends once its envelope is below this (-120 dB)
+    bool noteReleased{ false };
+
+    //mono render then pan, stereo only: one noise stream and one filter, placed by the note
+    bool pannedMono{ false };
+    float stereoWidth{ 0.5f };
+    float panLeft{ 1.0f };
+    float panRight{ 1.0f };
+    juce::SmoothedValue<float> gain{ 1.0f }; //folded into the envelope, the filters are linear, smoothed at control rate
+
+    //per note expression: MIDI only stores the sources, the matrix is evaluated and smoothed on the control grid
+    ModulationMatrix modulationMatrix;
+    ModulationMatrix::Sources modulationSources{};
+    juce::SmoothedValue<float> noteOffset; //semitones, pitch bend included
+    juce::SmoothedValue<float> resonanceOffset; //octaves of Q
+    juce::SmoothedValue<float> gainOffset; //dB
+    juce::SmoothedValue<float> envelopeTimeOffset; //octaves of time
+    float modulationGain{ 1.0f }; //gainOffset as a factor, folded into the envelope with gain
+    float appliedNoteOffset{ 0.0f }; //offsets the filter coefficients were last refreshed with
+    float appliedResonanceOffset{ 0.0f };
+    int modulationSamplesLeft{ 0 }; //samples until the next modulation step
+    bool modulationPending{ false }; //a source or the routing changed since the last step
+    bool modulationIsMoving{ false }; //pending or still gliding, renderModulation has nothing to do otherwise
 
     bool busy{ false };
-    juce::AudioBuffer<float> laplandBuffer;
+    ScratchArena* scratch{ nullptr }; //owned by the processor, shared by all voices
+    int scratchSlot{ 0 };
+
+    //intrusive active list, only touched by LaplandSynthesiser
+    friend class LaplandSynthesiser;
+    SynthVoice* previousActive{ nullptr };
+    SynthVoice* nextActive{ nullptr };
+    bool isListed{ false };
 };
\ No newline at end of file
@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    VoiceBank.cpp
+    Created: 20 Oct 2026 10:14:09am
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#include "VoiceBank.h"
+
+void VoiceBank::prepare(int numVoices, int numChannels, int numWorkspaces)
+{
+    jassert(numChannels <= maxChannels);
+
+    //the processor grows its pool while notes sound, so the voices that were already here keep their state
+    const auto previousSlots = numSlots;
+    numSlots = juce::jmax(1, numVoices);
+
+    for (auto* state : { &state1, &state2 })
+    {
+        std::vector<float> resized((size_t)(maxChannels * numSlots), 0.0f);
+
+        for (int channel = 0; channel < maxChannels; ++channel)
+            for (int slot = 0; slot < juce::jmin(previousSlots, numSlots); ++slot)
+                resized[(size_t)(channel * numSlots + slot)] = (*state)[(size_t)(channel * previousSlots + slot)];
+
+        state->swap(resized);
+    }
+    workspaces.resize((size_t)juce::jmax(1, numWorkspaces));
+}
+
+void VoiceBank::reset() noexcept
+{
+    std::fill(state1.begin(), state1.end(), 0.0f);
+    std::fill(state2.begin(), state2.end(), 0.0f);
+}
+
+void VoiceBank::render(int workspaceIndex, juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples, SynthVoice* const* voices, int numVoices) noexcept
+{
+    if (numVoices == 0) { return; }
+
+    jassert(workspaceIndex < (int)workspaces.size());
+    auto& workspace = workspaces[(size_t)workspaceIndex];
+    auto& accumulator = workspace.accumulator;
+
+    const auto channels = juce::jmin(outputBuffer.getNumChannels(), maxChannels);
+
+    for (int tileStart = startSample; tileStart < startSample + numSamples; tileStart += tileSize)
+    {
+        const auto tileLength = juce::jmin(tileSize, startSample + numSamples - tileStart);
+
+        for (int channel = 0; channel < channels; ++channel)
+        {
+            std::fill(accumulator[channel], accumulator[channel] + tileLength * numLanes, 0.0f);
+        }
+
+        for (int first = 0; first < numVoices; first += numLanes)
+        {
+            renderGroup(workspace, voices + first, juce::jmin(numLanes, numVoices - first), channels, tileStart, tileLength);
+        }
+
+        for (int channel = 0; channel < channels; ++channel)
+        {
+            auto* out = outputBuffer.getWritePointer(channel, tileStart);
+            const auto* sums = accumulator[channel];
+
+            for (int sample = 0; sample < tileLength; ++sample, sums += numLanes)
+            {
+                auto total = 0.0f;
+                for (int lane = 0; lane < numLanes; ++lane) { total += sums[lane]; }
+                out[sample] += total;
+            }
+        }
+    }
+
+    for (int i = 0; i < numVoices; ++i)
+    {
+        voices[i]->finishBlock();
+    }
+}
+
+void VoiceBank::renderGroup(Workspace& workspace, SynthVoice* const* voices, int numActiveLanes, int channels, int tileStart, int tileLength) noexcept
+{
+    //expression moves the coefficients at most once per tile
+    for (int lane = 0; lane < numActiveLanes; ++lane)
+    {
+        voices[lane]->renderModulation(tileLength);
+    }
+
+    //unused lanes get silent coefficients and a zero envelope, so they add nothing
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        const auto c = lane < numActiveLanes ? voices[lane]->getFilterCoefficients() : BiquadCoefficients{ 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+        workspace.b0[lane] = c.b0;
+        workspace.b1[lane] = c.b1;
+        workspace.b2[lane] = c.b2;
+        workspace.a1[lane] = c.a1;
+        workspace.a2[lane] = c.a2;
+    }
+
+    const auto b0 = Register::fromRawArray(workspace.b0);
+    const auto b1 = Register::fromRawArray(workspace.b1);
+    const auto b2 = Register::fromRawArray(workspace.b2);
+    const auto a1 = Register::fromRawArray(workspace.a1);
+    const auto a2 = Register::fromRawArray(workspace.a2);
+
+    //the envelope is stepped once per sample frame, whatever the channel count
+    for (int lane = 0; lane < numActiveLanes; ++lane)
+    {
+        voices[lane]->renderEnvelope(workspace.laneRows[lane], tileLength);
+    }
+    transposeRows(workspace, workspace.envelopeTile, numActiveLanes, tileLength);
+
+    const auto panned = pannedMono && channels == 2;
+    const auto filteredChannels = panned ? 1 : channels;
+
+    for (int lane = 0; lane < numLanes; ++lane)
+    {
+        workspace.panLeft[lane] = lane < numActiveLanes ? voices[lane]->getPanLeft() : 0.0f;
+        workspace.panRight[lane] = lane < numActiveLanes ? voices[lane]->getPanRight() : 0.0f;
+    }
+
+    const auto panLeft = Register::fromRawArray(workspace.panLeft);
+    const auto panRight = Register::fromRawArray(workspace.panRight);
+
+    for (int channel = 0; channel < filteredChannels; ++channel)
+    {
+        for (int lane = 0; lane < numActiveLanes; ++lane)
+        {
+            voices[lane]->renderNoise(workspace.laneRows[lane], channel, tileStart, tileLength);
+        }
+        transposeRows(workspace, workspace.inputTile, numActiveLanes, tileLength);
+
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            const auto slot = lane < numActiveLanes ? (size_t)(channel * numSlots + voices[lane]->getVoiceIndex()) : 0;
+            workspace.s1[lane] = lane < numActiveLanes ? state1[slot] : 0.0f;
+            workspace.s2[lane] = lane < numActiveLanes ? state2[slot] : 0.0f;
+        }
+
+        auto s1 = Register::fromRawArray(workspace.s1);
+        auto s2 = Register::fromRawArray(workspace.s2);
+
+        auto* sums = workspace.accumulator[channel];
+        auto* rightSums = workspace.accumulator[1];
+
+        for (int sample = 0; sample < tileLength; ++sample)
+        {
+            const auto offset = sample * numLanes;
+            const auto x = Register::fromRawArray(workspace.inputTile + offset);
+
+            const auto y = b0 * x + s1;
+            s1 = b1 * x - a1 * y + s2;
+            s2 = b2 * x - a2 * y;
+
+            const auto out = y * Register::fromRawArray(workspace.envelopeTile + offset);
+
+            if (panned)
+            {
+                (Register::fromRawArray(sums + offset) + out * panLeft).copyToRawArray(sums + offset);
+                (Register::fromRawArray(rightSums + offset) + out * panRight).copyToRawArray(rightSums + offset);
+            }
+            else
+            {
+                (Register::fromRawArray(sums + offset) + out).copyToRawArray(sums + offset);
+            }
+        }
+
+        s1.copyToRawArray(workspace.s1);
+        s2.copyToRawArray(workspace.s2);
+
+        for (int lane = 0; lane < numActiveLanes; ++lane)
+        {
+            const auto slot = (size_t)(channel * numSlots + voices[lane]->getVoiceIndex());
+            JUCE_SNAP_TO_ZERO(workspace.s1[lane]);
+            JUCE_SNAP_TO_ZERO(workspace.s2[lane]);
+            state1[slot] = workspace.s1[lane];
+            state2[slot] = workspace.s2[lane];
+        }
+    }
+}
+
+void VoiceBank::transposeRows(Workspace& workspace, float* destination, int numActiveLanes, int tileLength) noexcept
+{
+    for (int sample = 0; sample < tileLength; ++sample)
+    {
+        auto* frame = destination + sample * numLanes;
+
+        for (int lane = 0; lane < numActiveLanes; ++lane) { frame[lane] = workspace.laneRows[lane][sample]; }
+        for (int lane = numActiveLanes; lane < numLanes; ++lane) { frame[lane] = 0.0f; }
+    }
+}
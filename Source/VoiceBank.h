@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    VoiceBank.h
+    Created: 20 Oct 2026 10:14:09am
+    Author:  garfi
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "SynthVoice.h"
+
+/*Renders the low-pass voices several at a time, one voice per SIMD lane (4 with SSE/NEON, 8 with AVX).
+  The biquad recursion is serial inside a voice but independent between voices, so a register of
+  voices costs about as much as one scalar voice.
+  Filter states live here in structure-of-arrays form, indexed by voice index. Work is done in short
+  tiles: every lane writes its envelope and noise into a row, the rows are transposed so one sample
+  of every lane sits in one register, and the filtered, enveloped lanes are summed into a small
+  accumulator that is folded into the output once per tile.
+  The tile memory is kept per workspace, so several threads can render disjoint sets of voices at once.
+  In panned mono mode a stereo output filters only one channel per voice, and each lane is added to
+  both accumulators with its voice's pan gains.*/
+class VoiceBank
+{
+public:
+    using Register = juce::dsp::SIMDRegister<float>;
+
+    static constexpr int numLanes = (int)Register::SIMDNumElements;
+    static constexpr int tileSize = 64;
+    static constexpr int maxChannels = 2;
+
+    void prepare(int numVoices, int numChannels, int numWorkspaces = 1);
+    void reset() noexcept;
+    void setPannedMono(bool shouldPan) noexcept { pannedMono = shouldPan; }
+    bool isPannedMono() const noexcept { return pannedMono; }
+
+    //voices must all be active and usesVoiceBank(), startSample is the position in outputBuffer
+    //each thread rendering at the same time needs its own workspace index
+    void render(int workspaceIndex, juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples, SynthVoice* const* voices, int numVoices) noexcept;
+
+private:
+    struct alignas(32) Workspace
+    {
+        float laneRows[numLanes][tileSize];
+        float envelopeTile[tileSize * numLanes];
+        float inputTile[tileSize * numLanes];
+        float accumulator[maxChannels][tileSize * numLanes];
+
+        float b0[numLanes], b1[numLanes], b2[numLanes], a1[numLanes], a2[numLanes];
+        float s1[numLanes], s2[numLanes];
+        float panLeft[numLanes], panRight[numLanes];
+    };
+
+    void renderGroup(Workspace& workspace, SynthVoice* const* voices, int numActiveLanes, int channels, int tileStart, int tileLength) noexcept;
+    static void transposeRows(Workspace& workspace, float* destination, int numActiveLanes, int tileLength) noexcept;
+
+    std::vector<float> state1; //[channel * numSlots + voiceIndex]
+    std::vector<float> state2;
+    int numSlots{ 0 };
+    bool pannedMono{ false };
+
+    std::vector<Workspace> workspaces;
+};
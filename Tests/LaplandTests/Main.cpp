@@ -0,0 +1,401 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 23 Oct 2026 10:14:52am
+    Author:  garfi
+
+    Regression tests over the checked-in scenarios in Scenarios/: a MIDI
+    file plus parameters each, rendered seeded and compared with the golden
+    render stored next to them. Every scenario is also rendered on several
+    threads and with the VoiceBank bypassed, both have to match the serial
+    render. Goldens are bit exact renders of one toolchain, named in
+    Scenarios/goldens.txt, and only checked by a build of that toolchain.
+    Built by the LaplandTests target in the top level CMakeLists.txt and
+    run by ctest.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    //goldens come from the same code on the same toolchain, anything but bit identical is a change.
+    //The scalar reference sums the voices in another order than the VoiceBank, only that one is rounding
+    constexpr float defaultGoldenTolerance = 0.0f;
+    constexpr float implementationTolerance = 1.0e-5f;
+
+    struct Options
+    {
+        juce::File scenarioDirectory;
+        juce::String only;
+        bool update{ false };
+        bool checkGoldens{ false }; //the goldens were made by this toolchain
+    };
+
+    struct Scenario
+    {
+        juce::String name;
+        juce::File midiFile;
+        juce::File goldenFile;
+        juce::StringPairArray parameters;
+        double sampleRate{ 48000.0 };
+        int blockSize{ 512 };
+        int numChannels{ 2 };
+        double tailSeconds{ 0.5 };
+        juce::int64 seed{ 1 };
+        float goldenTolerance{ defaultGoldenTolerance };
+    };
+
+    void printUsage()
+    {
+        std::cout << "usage: LaplandTests <scenario directory> [options]\n"
+                     "  --only <name>     run one scenario\n"
+                     "  --update          rewrite the golden renders instead of checking them\n";
+    }
+
+    //what a bit exact render depends on besides the code: JUCE, the compiler, the CPU family and the build type
+    juce::String getToolchain()
+    {
+        juce::String toolchain;
+        toolchain << "JUCE " << JUCE_MAJOR_VERSION << "." << JUCE_MINOR_VERSION << "." << JUCE_BUILDNUMBER;
+
+       #if defined(__clang__)
+        toolchain << ", clang " << __clang_major__ << "." << __clang_minor__ << "." << __clang_patchlevel__;
+       #elif defined(__GNUC__)
+        toolchain << ", gcc " << __GNUC__ << "." << __GNUC_MINOR__ << "." << __GNUC_PATCHLEVEL__;
+       #elif defined(_MSC_VER)
+        toolchain << ", MSVC " << _MSC_FULL_VER;
+       #endif
+
+       #if JUCE_INTEL
+        toolchain << ", x86";
+       #elif JUCE_ARM
+        toolchain << ", arm";
+       #endif
+        toolchain << (sizeof(void*) == 8 ? " 64 bit" : " 32 bit");
+
+       #if JUCE_DEBUG
+        toolchain << ", debug";
+       #else
+        toolchain << ", release";
+       #endif
+
+        return toolchain;
+    }
+
+    bool parseOptions(const juce::StringArray& args, Options& options)
+    {
+        juce::StringArray positional;
+
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+            const auto next = [&]() { return i + 1 < args.size() ? args[++i] : juce::String(); };
+
+            if (arg == "--only")            options.only = next();
+            else if (arg == "--update")     options.update = true;
+            else if (arg.startsWith("--"))
+            {
+                std::cerr << "unknown option " << arg << "\n";
+                return false;
+            }
+            else
+            {
+                positional.add(arg);
+            }
+        }
+
+        if (positional.size() != 1) { return false; }
+
+        options.scenarioDirectory = juce::File::getCurrentWorkingDirectory().getChildFile(positional[0]);
+        return true;
+    }
+
+    //one setting per line, '#' starts a comment:
+    //  midi <file>            relative to the scenario
+    //  rate <Hz>, block <samples>, channels <1|2>, tail <seconds>, seed <n>
+    //  tolerance <linear>     golden tolerance as a fraction of the golden's peak, default 0 (bit exact).
+    //                         Only for a documented platform difference, say which one next to it
+    //  param <ID> <value>     may be repeated
+    bool loadScenario(const juce::File& file, Scenario& scenario)
+    {
+        scenario.name = file.getFileNameWithoutExtension();
+        scenario.goldenFile = file.withFileExtension("f32");
+
+        for (auto line : juce::StringArray::fromLines(file.loadFileAsString()))
+        {
+            line = line.upToFirstOccurrenceOf("#", false, false).trim();
+            if (line.isEmpty()) { continue; }
+
+            const auto tokens = juce::StringArray::fromTokens(line, true);
+            const auto& key = tokens[0];
+
+            if (key == "midi")              scenario.midiFile = file.getSiblingFile(tokens[1]);
+            else if (key == "rate")         scenario.sampleRate = tokens[1].getDoubleValue();
+            else if (key == "block")        scenario.blockSize = tokens[1].getIntValue();
+            else if (key == "channels")     scenario.numChannels = tokens[1].getIntValue();
+            else if (key == "tail")         scenario.tailSeconds = tokens[1].getDoubleValue();
+            else if (key == "seed")         scenario.seed = tokens[1].getLargeIntValue();
+            else if (key == "tolerance")    scenario.goldenTolerance = tokens[1].getFloatValue();
+            else if (key == "param" && tokens.size() == 3)
+            {
+                scenario.parameters.set(tokens[1], tokens[2]);
+            }
+            else
+            {
+                std::cerr << file.getFileName() << ": cannot read '" << line << "'\n";
+                return false;
+            }
+        }
+
+        return scenario.midiFile.existsAsFile() && scenario.sampleRate > 0.0 && scenario.blockSize > 0
+            && (scenario.numChannels == 1 || scenario.numChannels == 2);
+    }
+
+    bool loadMidi(const juce::File& file, juce::MidiMessageSequence& sequence)
+    {
+        juce::FileInputStream stream(file);
+        juce::MidiFile midi;
+
+        if (!stream.openedOk() || !midi.readFrom(stream)) { return false; }
+
+        midi.convertTimestampTicksToSeconds();
+
+        for (int track = 0; track < midi.getNumTracks(); ++track)
+            sequence.addSequence(*midi.getTrack(track), 0.0);
+
+        sequence.updateMatchedPairs();
+        return true;
+    }
+
+    //renders the whole scenario like LaplandRender does, one block at a time with the events placed to the sample
+    bool render(const Scenario& scenario, const juce::MidiMessageSequence& sequence, int renderThreads, bool useVoiceBank, juce::AudioBuffer<float>& output)
+    {
+        LaplandAudioProcessor processor;
+
+        for (const auto& id : scenario.parameters.getAllKeys())
+        {
+            auto* parameter = processor.apvts.getParameter(id);
+            if (parameter == nullptr)
+            {
+                std::cerr << scenario.name << ": unknown parameter " << id << "\n";
+                return false;
+            }
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(scenario.parameters[id].getFloatValue()));
+        }
+
+        auto* threads = processor.apvts.getParameter("RenderThreads");
+        threads->setValueNotifyingHost(threads->convertTo0to1((float)renderThreads));
+
+        processor.setPlayConfigDetails(0, scenario.numChannels, scenario.sampleRate, scenario.blockSize);
+        processor.setNonRealtime(true);
+        processor.setNoiseSeed(scenario.seed);
+        processor.setVoiceBankEnabled(useVoiceBank);
+        processor.prepareToPlay(scenario.sampleRate, scenario.blockSize);
+
+        const auto totalSamples = (int)std::ceil((sequence.getEndTime() + scenario.tailSeconds) * scenario.sampleRate);
+        output.setSize(scenario.numChannels, totalSamples);
+        output.clear();
+
+        juce::MidiBuffer midi;
+        int nextEvent = 0;
+
+        for (int position = 0; position < totalSamples; position += scenario.blockSize)
+        {
+            const auto numSamples = juce::jmin(scenario.blockSize, totalSamples - position);
+
+            midi.clear();
+            for (; nextEvent < sequence.getNumEvents(); ++nextEvent)
+            {
+                const auto& message = sequence.getEventPointer(nextEvent)->message;
+                const auto eventSample = (int)std::llround(message.getTimeStamp() * scenario.sampleRate);
+                if (eventSample >= position + numSamples) { break; }
+
+                midi.addEvent(message, juce::jmax(0, eventSample - position));
+            }
+
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), scenario.numChannels, position, numSamples);
+            processor.processBlock(block, midi);
+        }
+
+        processor.releaseResources();
+        return true;
+    }
+
+    //golden renders are interleaved little-endian float32, the same as LaplandRender --raw writes
+    bool readGolden(const juce::File& file, int numChannels, juce::AudioBuffer<float>& golden)
+    {
+        juce::MemoryBlock data;
+        if (!file.loadFileAsData(data)) { return false; }
+
+        const auto numFrames = (int)(data.getSize() / (sizeof(float) * (size_t)numChannels));
+        golden.setSize(numChannels, numFrames);
+
+        juce::MemoryInputStream stream(data, false);
+        for (int sample = 0; sample < numFrames; ++sample)
+            for (int channel = 0; channel < numChannels; ++channel)
+                golden.setSample(channel, sample, stream.readFloat());
+
+        return true;
+    }
+
+    bool writeGolden(const juce::File& file, const juce::AudioBuffer<float>& audio)
+    {
+        file.deleteFile();
+        juce::FileOutputStream stream(file);
+        if (!stream.openedOk()) { return false; }
+
+        for (int sample = 0; sample < audio.getNumSamples(); ++sample)
+            for (int channel = 0; channel < audio.getNumChannels(); ++channel)
+                if (!stream.writeFloat(audio.getSample(channel, sample))) { return false; }
+
+        return true;
+    }
+
+    //largest difference relative to the expected peak, a length mismatch or a NaN fails outright
+    bool check(const juce::String& what, const juce::AudioBuffer<float>& rendered, const juce::AudioBuffer<float>& expected, float tolerance)
+    {
+        auto peak = 0.0f;
+        auto maxDifference = 0.0f;
+        auto valid = rendered.getNumSamples() == expected.getNumSamples() && rendered.getNumChannels() == expected.getNumChannels();
+
+        for (int channel = 0; valid && channel < expected.getNumChannels(); ++channel)
+        {
+            for (int sample = 0; sample < expected.getNumSamples(); ++sample)
+            {
+                const auto difference = std::abs(rendered.getSample(channel, sample) - expected.getSample(channel, sample));
+                valid = valid && difference == difference;
+                peak = juce::jmax(peak, std::abs(expected.getSample(channel, sample)));
+                maxDifference = juce::jmax(maxDifference, difference);
+            }
+        }
+
+        const auto relative = peak > 0.0f ? maxDifference / peak : maxDifference;
+        const auto passed = valid && peak > 0.0f && relative <= tolerance;
+
+        std::cout << "  " << what << ": " << (passed ? "ok" : "FAILED") << ", difference " << relative << " of the peak (tolerance " << tolerance << ")";
+        if (rendered.getNumSamples() != expected.getNumSamples())
+            std::cout << ", length " << rendered.getNumSamples() << " rendered vs " << expected.getNumSamples() << " expected";
+        if (peak == 0.0f)
+            std::cout << ", the expected render is silent";
+        std::cout << "\n";
+
+        return passed;
+    }
+
+    bool runScenario(const juce::File& file, const Options& options)
+    {
+        Scenario scenario;
+        juce::MidiMessageSequence sequence;
+
+        if (!loadScenario(file, scenario) || !loadMidi(scenario.midiFile, sequence))
+        {
+            std::cerr << "could not load scenario " << file.getFullPathName() << "\n";
+            return false;
+        }
+
+        std::cout << scenario.name << "\n";
+
+        juce::AudioBuffer<float> serial;
+        if (!render(scenario, sequence, 1, true, serial)) { return false; }
+
+        if (options.update)
+        {
+            const auto written = writeGolden(scenario.goldenFile, serial);
+            std::cout << "  golden: " << (written ? "written" : "WRITE FAILED") << "\n";
+            return written;
+        }
+
+        auto passed = true;
+
+        juce::AudioBuffer<float> golden;
+        if (!options.checkGoldens)
+        {
+            std::cout << "  golden: skipped, none recorded for this toolchain\n";
+        }
+        else if (readGolden(scenario.goldenFile, scenario.numChannels, golden))
+        {
+            passed = check("golden", serial, golden, scenario.goldenTolerance) && passed;
+        }
+        else
+        {
+            std::cout << "  golden: FAILED, cannot read " << scenario.goldenFile.getFullPathName() << "\n";
+            passed = false;
+        }
+
+        //every thread count sums the same chunks in the same order, so they all have to agree exactly.
+        //On machines with fewer cores the processor clamps RenderThreads and these compare less
+        juce::AudioBuffer<float> twoThreads, fourThreads, scalar;
+        if (!render(scenario, sequence, 2, true, twoThreads) || !render(scenario, sequence, 4, true, fourThreads)) { return false; }
+
+        passed = check("4 threads vs serial", fourThreads, serial, 0.0f) && passed;
+        passed = check("2 threads vs 4 threads", twoThreads, fourThreads, 0.0f) && passed;
+
+        //the low-pass voices one at a time, the VoiceBank's SIMD lanes have to give the same audio
+        if (!render(scenario, sequence, 1, false, scalar)) { return false; }
+
+        passed = check("voice bank vs scalar", serial, scalar, implementationTolerance) && passed;
+
+        return passed;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+    if (!parseOptions(juce::StringArray(argv + 1, argc - 1), options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    //a golden only means something on the toolchain that rendered it, and regenerating on another one
+    //would hide whatever changed. Write them with --update on the reference build and commit goldens.txt along
+    const auto toolchain = getToolchain();
+    const auto toolchainFile = options.scenarioDirectory.getChildFile("goldens.txt");
+    const auto goldenToolchain = toolchainFile.loadFileAsString().trim();
+    options.checkGoldens = goldenToolchain == toolchain;
+
+    std::cout << "this build: " << toolchain << "\n"
+              << "goldens:    " << (goldenToolchain.isEmpty() ? juce::String("none recorded") : goldenToolchain) << "\n";
+
+    if (options.update && options.only.isNotEmpty() && !options.checkGoldens)
+    {
+        std::cerr << "the goldens come from another toolchain, regenerate all of them\n";
+        return 1;
+    }
+
+    if (options.update && !toolchainFile.replaceWithText(toolchain + "\n"))
+    {
+        std::cerr << "could not write " << toolchainFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    auto scenarios = options.scenarioDirectory.findChildFiles(juce::File::findFiles, false, "*.scenario");
+    scenarios.sort();
+
+    int numRun = 0;
+    int numFailed = 0;
+
+    for (const auto& file : scenarios)
+    {
+        if (options.only.isNotEmpty() && file.getFileNameWithoutExtension() != options.only) { continue; }
+
+        ++numRun;
+        if (!runScenario(file, options)) { ++numFailed; }
+    }
+
+    if (numRun == 0)
+    {
+        std::cerr << "no scenarios in " << options.scenarioDirectory.getFullPathName() << "\n";
+        return 1;
+    }
+
+    std::cout << numRun - numFailed << " of " << numRun << " scenarios passed\n";
+    return numFailed == 0 ? 0 : 2;
+}
@@ -0,0 +1,215 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 21 Oct 2026 2:05:17pm
+    Author:  garfi
+
+    processBlock benchmark over voice counts, block sizes, sample rates and
+    channel counts. Prints a table and optionally writes JSON so runs can be
+    diffed for regressions. Built by the LaplandBench target in the top
+    level CMakeLists.txt, headless like LaplandRender.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <numeric>
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    struct Options
+    {
+        juce::Array<int> voiceCounts{ 1, 8, 22, 64 };
+        juce::Array<int> blockSizes{ 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+        juce::Array<double> sampleRates{ 44100.0, 48000.0, 96000.0, 192000.0 };
+        juce::Array<int> channelCounts{ 1, 2 };
+        double seconds{ 2.0 };
+        double warmUpSeconds{ 0.25 };
+        juce::File jsonFile;
+    };
+
+    struct Result
+    {
+        int voices, blockSize, channels;
+        double sampleRate;
+        double nsPerSample, nsPerVoiceSample, meanBlockMicroseconds, p99BlockMicroseconds, deadlineMicroseconds;
+    };
+
+    template <typename Type>
+    juce::Array<Type> parseList(const juce::String& text)
+    {
+        juce::Array<Type> values;
+        for (const auto& token : juce::StringArray::fromTokens(text, ",", {}))
+            values.add((Type)token.getDoubleValue());
+        return values;
+    }
+
+    void printUsage()
+    {
+        std::cout << "usage: LaplandBench [options]\n"
+                     "  --voices <list>      held notes, default 1,8,22,64\n"
+                     "  --blocks <list>      block sizes, default 32,...,4096\n"
+                     "  --rates <list>       sample rates, default 44100,48000,96000,192000\n"
+                     "  --channels <list>    channel counts, default 1,2\n"
+                     "  --seconds <s>        measured audio per case, default 2\n"
+                     "  --json <file>        write the results as JSON\n";
+    }
+
+    bool parseOptions(const juce::StringArray& args, Options& options)
+    {
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+            const auto next = [&]() { return i + 1 < args.size() ? args[++i] : juce::String(); };
+
+            if (arg == "--voices")          options.voiceCounts = parseList<int>(next());
+            else if (arg == "--blocks")     options.blockSizes = parseList<int>(next());
+            else if (arg == "--rates")      options.sampleRates = parseList<double>(next());
+            else if (arg == "--channels")   options.channelCounts = parseList<int>(next());
+            else if (arg == "--seconds")    options.seconds = next().getDoubleValue();
+            else if (arg == "--json")       options.jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(next());
+            else
+            {
+                std::cerr << "unknown option " << arg << "\n";
+                return false;
+            }
+        }
+
+        return options.seconds > 0.0 && !options.voiceCounts.isEmpty() && !options.blockSizes.isEmpty()
+            && !options.sampleRates.isEmpty() && !options.channelCounts.isEmpty();
+    }
+
+    void setParameter(LaplandAudioProcessor& processor, const juce::String& id, float value)
+    {
+        if (auto* parameter = processor.apvts.getParameter(id))
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    }
+
+    Result runCase(int voices, int blockSize, double sampleRate, int channels, const Options& options)
+    {
+        LaplandAudioProcessor processor;
+        setParameter(processor, "Polyphony", (float)voices);
+        setParameter(processor, "Sustain", 1.0f); //keep every voice at full level for the whole run
+
+        processor.setPlayConfigDetails(0, channels, sampleRate, blockSize);
+        processor.setNonRealtime(true);
+        processor.prepareToPlay(sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer(channels, blockSize);
+        juce::MidiBuffer midi;
+
+        //notes are spread over the keyboard so the voices do not share filter settings
+        for (int voice = 0; voice < voices; ++voice)
+            midi.addEvent(juce::MidiMessage::noteOn(1, 24 + (voice * 7) % 96, 0.8f), 0);
+
+        const auto warmUpBlocks = (int)std::ceil(options.warmUpSeconds * sampleRate / blockSize);
+        const auto measuredBlocks = juce::jmax(1, (int)std::ceil(options.seconds * sampleRate / blockSize));
+
+        std::vector<double> blockTimes;
+        blockTimes.reserve((size_t)measuredBlocks);
+
+        for (int block = 0; block < warmUpBlocks + measuredBlocks; ++block)
+        {
+            buffer.clear();
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            const auto end = juce::Time::getHighResolutionTicks();
+
+            midi.clear();
+            if (block >= warmUpBlocks)
+                blockTimes.push_back(juce::Time::highResolutionTicksToSeconds(end - start));
+        }
+
+        processor.releaseResources();
+
+        const auto totalSeconds = std::accumulate(blockTimes.begin(), blockTimes.end(), 0.0);
+        const auto totalSamples = (double)measuredBlocks * blockSize;
+
+        std::sort(blockTimes.begin(), blockTimes.end());
+        const auto p99 = blockTimes[(size_t)juce::jmin((int)blockTimes.size() - 1, (int)std::ceil(0.99 * (double)blockTimes.size()) - 1)];
+
+        Result result;
+        result.voices = voices;
+        result.blockSize = blockSize;
+        result.channels = channels;
+        result.sampleRate = sampleRate;
+        result.nsPerSample = totalSeconds * 1.0e9 / totalSamples;
+        result.nsPerVoiceSample = result.nsPerSample / voices;
+        result.meanBlockMicroseconds = totalSeconds * 1.0e6 / measuredBlocks;
+        result.p99BlockMicroseconds = p99 * 1.0e6;
+        result.deadlineMicroseconds = blockSize * 1.0e6 / sampleRate;
+        return result;
+    }
+
+    juce::var toJson(const juce::Array<Result>& results)
+    {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty("numCpus", juce::SystemStats::getNumCpus());
+        root->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+
+        juce::Array<juce::var> cases;
+        for (const auto& result : results)
+        {
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("voices", result.voices);
+            entry->setProperty("blockSize", result.blockSize);
+            entry->setProperty("sampleRate", result.sampleRate);
+            entry->setProperty("channels", result.channels);
+            entry->setProperty("nsPerSample", result.nsPerSample);
+            entry->setProperty("nsPerVoiceSample", result.nsPerVoiceSample);
+            entry->setProperty("meanBlockUs", result.meanBlockMicroseconds);
+            entry->setProperty("p99BlockUs", result.p99BlockMicroseconds);
+            entry->setProperty("deadlineUs", result.deadlineMicroseconds);
+            cases.add(juce::var(entry));
+        }
+
+        root->setProperty("results", cases);
+        return juce::var(root);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+    if (!parseOptions(juce::StringArray(argv + 1, argc - 1), options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    juce::Array<Result> results;
+
+    std::cout << "voices  block     rate  ch   ns/sample  ns/voice-sample  mean us   p99 us  deadline us\n";
+
+    for (auto voices : options.voiceCounts)
+        for (auto blockSize : options.blockSizes)
+            for (auto sampleRate : options.sampleRates)
+                for (auto channels : options.channelCounts)
+                {
+                    const auto result = runCase(voices, blockSize, sampleRate, channels, options);
+                    results.add(result);
+
+                    std::cout << juce::String(voices).paddedLeft(' ', 6) << juce::String(blockSize).paddedLeft(' ', 7)
+                              << juce::String(sampleRate, 0).paddedLeft(' ', 9) << juce::String(channels).paddedLeft(' ', 4)
+                              << juce::String(result.nsPerSample, 2).paddedLeft(' ', 12) << juce::String(result.nsPerVoiceSample, 2).paddedLeft(' ', 17)
+                              << juce::String(result.meanBlockMicroseconds, 1).paddedLeft(' ', 9) << juce::String(result.p99BlockMicroseconds, 1).paddedLeft(' ', 9)
+                              << juce::String(result.deadlineMicroseconds, 1).paddedLeft(' ', 13) << "\n";
+                }
+
+    if (options.jsonFile != juce::File())
+    {
+        if (!options.jsonFile.replaceWithText(juce::JSON::toString(toJson(results))))
+        {
+            std::cerr << "could not write " << options.jsonFile.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
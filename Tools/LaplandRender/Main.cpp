@@ -0,0 +1,376 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Created: 21 Oct 2026 9:12:40am
+    Author:  garfi
+
+    Headless offline renderer: Standard MIDI File in, WAV or raw float out.
+    Built by the LaplandRender target in the top level CMakeLists.txt, which
+    compiles the plugin's Source/ files with LAPLAND_HEADLESS (no editor).
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+namespace
+{
+    struct Options
+    {
+        juce::File midiFile;
+        juce::File outputFile;
+        juce::File presetFile;
+        juce::File goldenFile;
+        juce::StringPairArray parameters;
+        double sampleRate{ 48000.0 };
+        int blockSize{ 512 };
+        int numChannels{ 2 };
+        int bitsPerSample{ 24 };
+        double tailSeconds{ 1.0 };
+        float tolerance{ 0.0f };
+        juce::int64 seed{ 0 };
+        bool seeded{ false };
+        bool rawFloat{ false };
+    };
+
+    void printUsage()
+    {
+        std::cout << "usage: LaplandRender <in.mid> <out.wav|out.raw> [options]\n"
+                     "  --rate <Hz>              sample rate, default 48000\n"
+                     "  --block <samples>        processBlock size, default 512\n"
+                     "  --channels <1|2>         output channels, default 2\n"
+                     "  --bits <16|24|32>        WAV bit depth, 32 is float, default 24\n"
+                     "  --raw                    write interleaved little-endian float32 instead of WAV\n"
+                     "  --preset <file>          plugin state, binary as saved by the plugin or an XML value tree\n"
+                     "  --param <ID>=<value>     set one parameter, may be repeated\n"
+                     "  --tail <seconds>         minimum render time after the last event, default 1\n"
+                     "  --seed <n>               seed the noise, the same seed, MIDI and parameters render identical audio\n"
+                     "  --golden <file>          compare with a stored render (raw float32 or float WAV), needs --seed\n"
+                     "  --tolerance <linear>     largest accepted difference per sample, default 0 (bit exact)\n";
+    }
+
+    bool parseOptions(const juce::StringArray& args, Options& options)
+    {
+        juce::StringArray positional;
+
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args[i];
+            const auto next = [&]() { return i + 1 < args.size() ? args[++i] : juce::String(); };
+
+            if (arg == "--rate")            options.sampleRate = next().getDoubleValue();
+            else if (arg == "--block")      options.blockSize = next().getIntValue();
+            else if (arg == "--channels")   options.numChannels = next().getIntValue();
+            else if (arg == "--bits")       options.bitsPerSample = next().getIntValue();
+            else if (arg == "--raw")        options.rawFloat = true;
+            else if (arg == "--preset")     options.presetFile = juce::File::getCurrentWorkingDirectory().getChildFile(next());
+            else if (arg == "--tail")       options.tailSeconds = next().getDoubleValue();
+            else if (arg == "--golden")     options.goldenFile = juce::File::getCurrentWorkingDirectory().getChildFile(next());
+            else if (arg == "--tolerance")  options.tolerance = next().getFloatValue();
+            else if (arg == "--seed")
+            {
+                options.seed = next().getLargeIntValue();
+                options.seeded = true;
+            }
+            else if (arg == "--param")
+            {
+                const auto assignment = next();
+                options.parameters.set(assignment.upToFirstOccurrenceOf("=", false, false), assignment.fromFirstOccurrenceOf("=", false, false));
+            }
+            else if (arg.startsWith("--"))
+            {
+                std::cerr << "unknown option " << arg << "\n";
+                return false;
+            }
+            else
+            {
+                positional.add(arg);
+            }
+        }
+
+        if (positional.size() != 2) { return false; }
+
+        options.midiFile = juce::File::getCurrentWorkingDirectory().getChildFile(positional[0]);
+        options.outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(positional[1]);
+        options.rawFloat = options.rawFloat || options.outputFile.hasFileExtension("raw;f32");
+
+        //without a seed the noise differs on every run and nothing would match
+        if (options.goldenFile != juce::File() && !options.seeded)
+        {
+            std::cerr << "--golden needs --seed\n";
+            return false;
+        }
+
+        return options.sampleRate > 0.0 && options.blockSize > 0 && options.tolerance >= 0.0f
+            && (options.numChannels == 1 || options.numChannels == 2)
+            && (options.bitsPerSample == 16 || options.bitsPerSample == 24 || options.bitsPerSample == 32);
+    }
+
+    bool loadMidi(const juce::File& file, juce::MidiMessageSequence& sequence)
+    {
+        juce::FileInputStream stream(file);
+        juce::MidiFile midi;
+
+        if (!stream.openedOk() || !midi.readFrom(stream)) { return false; }
+
+        midi.convertTimestampTicksToSeconds();
+
+        for (int track = 0; track < midi.getNumTracks(); ++track)
+            sequence.addSequence(*midi.getTrack(track), 0.0);
+
+        sequence.updateMatchedPairs();
+        return true;
+    }
+
+    bool applyParameters(LaplandAudioProcessor& processor, const Options& options)
+    {
+        if (options.presetFile != juce::File())
+        {
+            juce::MemoryBlock state;
+            if (options.presetFile.loadFileAsData(state) && PresetFormat::isState(state.getData(), state.getSize()))
+            {
+                processor.setStateInformation(state.getData(), (int)state.getSize());
+            }
+            else
+            {
+                auto xml = juce::parseXML(options.presetFile);
+                if (xml == nullptr)
+                {
+                    std::cerr << "could not read preset " << options.presetFile.getFullPathName() << "\n";
+                    return false;
+                }
+                processor.apvts.replaceState(juce::ValueTree::fromXml(*xml));
+            }
+        }
+
+        for (const auto& id : options.parameters.getAllKeys())
+        {
+            auto* parameter = processor.apvts.getParameter(id);
+            if (parameter == nullptr)
+            {
+                std::cerr << "unknown parameter " << id << "\n";
+                return false;
+            }
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(options.parameters[id].getFloatValue()));
+        }
+
+        return true;
+    }
+
+    //wraps either a WAV writer or a raw float stream, so the render loop does not care
+    class OutputSink
+    {
+    public:
+        bool open(const Options& options)
+        {
+            options.outputFile.deleteFile();
+            auto stream = std::make_unique<juce::FileOutputStream>(options.outputFile);
+            if (!stream->openedOk()) { return false; }
+
+            if (options.rawFloat)
+            {
+                rawStream = std::move(stream);
+                return true;
+            }
+
+            juce::WavAudioFormat wav;
+            writer.reset(wav.createWriterFor(stream.get(), options.sampleRate, (unsigned int)options.numChannels, options.bitsPerSample, {}, 0));
+            if (writer != nullptr) { stream.release(); } //the writer owns it now
+            return writer != nullptr;
+        }
+
+        bool write(const juce::AudioBuffer<float>& buffer, int numSamples)
+        {
+            if (writer != nullptr) { return writer->writeFromAudioSampleBuffer(buffer, 0, numSamples); }
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+                {
+                    if (!rawStream->writeFloat(buffer.getSample(channel, sample))) { return false; }
+                }
+            }
+            return true;
+        }
+
+    private:
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        std::unique_ptr<juce::FileOutputStream> rawStream;
+    };
+
+    //a stored render to check against, block by block as the new one comes out.
+    //Store goldens as raw or 32 bit float, 16 and 24 bit WAVs only match within their quantisation
+    class GoldenReference
+    {
+    public:
+        bool load(const Options& options)
+        {
+            if (options.goldenFile.hasFileExtension("raw;f32"))
+            {
+                juce::MemoryBlock data;
+                if (!options.goldenFile.loadFileAsData(data)) { return false; }
+
+                const auto numFrames = (int)(data.getSize() / (sizeof(float) * (size_t)options.numChannels));
+                samples.setSize(options.numChannels, numFrames);
+
+                juce::MemoryInputStream stream(data, false);
+                for (int sample = 0; sample < numFrames; ++sample)
+                    for (int channel = 0; channel < options.numChannels; ++channel)
+                        samples.setSample(channel, sample, stream.readFloat());
+
+                return true;
+            }
+
+            juce::AudioFormatManager formats;
+            formats.registerBasicFormats();
+            std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(options.goldenFile));
+            if (reader == nullptr || (int)reader->numChannels != options.numChannels) { return false; }
+
+            samples.setSize(options.numChannels, (int)reader->lengthInSamples);
+            return reader->read(&samples, 0, (int)reader->lengthInSamples, 0, true, true);
+        }
+
+        void compare(const juce::AudioBuffer<float>& block, juce::int64 position, float tolerance)
+        {
+            for (int channel = 0; channel < block.getNumChannels(); ++channel)
+            {
+                const auto* rendered = block.getReadPointer(channel);
+
+                for (int sample = 0; sample < block.getNumSamples(); ++sample)
+                {
+                    const auto index = position + sample;
+                    const auto expected = index < samples.getNumSamples() ? samples.getSample(channel, (int)index) : 0.0f;
+                    const auto difference = std::abs(rendered[sample] - expected);
+                    maxDifference = juce::jmax(maxDifference, difference);
+
+                    //a NaN never compares greater, so test for the pass instead
+                    if (!(difference <= tolerance) && firstMismatch < 0)
+                    {
+                        firstMismatch = index;
+                        mismatchChannel = channel;
+                    }
+                }
+            }
+        }
+
+        //a golden longer than the render is a mismatch too, the output has gone missing
+        bool passed(juce::int64 renderedSamples) const noexcept
+        {
+            return firstMismatch < 0 && renderedSamples >= samples.getNumSamples();
+        }
+
+        void report(juce::int64 renderedSamples, float tolerance) const
+        {
+            std::cout << "golden: " << (passed(renderedSamples) ? "match" : "MISMATCH")
+                      << ", max difference " << maxDifference << " (tolerance " << tolerance << ")";
+            if (firstMismatch >= 0)
+                std::cout << ", first at sample " << firstMismatch << " channel " << mismatchChannel;
+            if (renderedSamples != samples.getNumSamples())
+                std::cout << ", length " << renderedSamples << " rendered vs " << samples.getNumSamples() << " stored";
+            std::cout << "\n";
+        }
+
+    private:
+        juce::AudioBuffer<float> samples;
+        float maxDifference{ 0.0f };
+        juce::int64 firstMismatch{ -1 };
+        int mismatchChannel{ 0 };
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+    if (!parseOptions(juce::StringArray(argv + 1, argc - 1), options))
+    {
+        printUsage();
+        return 1;
+    }
+
+    juce::MidiMessageSequence sequence;
+    if (!loadMidi(options.midiFile, sequence))
+    {
+        std::cerr << "could not read MIDI file " << options.midiFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    LaplandAudioProcessor processor;
+    if (!applyParameters(processor, options)) { return 1; }
+
+    processor.setPlayConfigDetails(0, options.numChannels, options.sampleRate, options.blockSize);
+    processor.setNonRealtime(true);
+    if (options.seeded) { processor.setNoiseSeed(options.seed); }
+    processor.prepareToPlay(options.sampleRate, options.blockSize);
+
+    OutputSink sink;
+    if (!sink.open(options))
+    {
+        std::cerr << "could not write " << options.outputFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    GoldenReference golden;
+    const auto checkGolden = options.goldenFile != juce::File();
+    if (checkGolden && !golden.load(options))
+    {
+        std::cerr << "could not read golden file " << options.goldenFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    const auto tailSeconds = juce::jmax(options.tailSeconds, processor.getTailLengthSeconds());
+    const auto totalSamples = (juce::int64)std::ceil((sequence.getEndTime() + tailSeconds) * options.sampleRate);
+
+    juce::AudioBuffer<float> buffer(options.numChannels, options.blockSize);
+    juce::MidiBuffer midi;
+    int nextEvent = 0;
+    double renderMilliseconds = 0.0;
+
+    for (juce::int64 position = 0; position < totalSamples; position += options.blockSize)
+    {
+        const auto numSamples = (int)juce::jmin((juce::int64)options.blockSize, totalSamples - position);
+
+        midi.clear();
+        for (; nextEvent < sequence.getNumEvents(); ++nextEvent)
+        {
+            const auto& message = sequence.getEventPointer(nextEvent)->message;
+            const auto eventSample = (juce::int64)std::llround(message.getTimeStamp() * options.sampleRate);
+            if (eventSample >= position + numSamples) { break; }
+
+            midi.addEvent(message, (int)juce::jmax((juce::int64)0, eventSample - position));
+        }
+
+        //the last block may be short, hand the processor a view of exactly that length
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), options.numChannels, numSamples);
+        block.clear();
+
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+        processor.processBlock(block, midi);
+        renderMilliseconds += juce::Time::getMillisecondCounterHiRes() - start;
+
+        if (!sink.write(block, numSamples))
+        {
+            std::cerr << "write failed\n";
+            return 1;
+        }
+
+        if (checkGolden) { golden.compare(block, position, options.tolerance); }
+    }
+
+    processor.releaseResources();
+
+    const auto audioSeconds = (double)totalSamples / options.sampleRate;
+    std::cout << "rendered " << audioSeconds << " s in " << renderMilliseconds / 1000.0 << " s of processBlock, "
+              << "real-time factor " << (renderMilliseconds > 0.0 ? audioSeconds * 1000.0 / renderMilliseconds : 0.0) << "x\n";
+
+    if (checkGolden)
+    {
+        golden.report(totalSamples, options.tolerance);
+        if (!golden.passed(totalSamples)) { return 2; }
+    }
+
+    return 0;
+}